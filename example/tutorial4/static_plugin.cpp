@@ -40,3 +40,6 @@ boost::shared_ptr<my_plugin_api> create_plugin() {
 
 //]
 
+// Registration that is visible to boost::dll::static_registry without -rdynamic
+#include <boost/dll/static_registry.hpp>
+BOOST_DLL_STATIC_REGISTER(my_namespace::create_plugin, create_plugin)
@@ -20,27 +20,22 @@ public:
 
 //[plugcpp_library_holding_deleter_api_bind
 #include <boost/shared_ptr.hpp>
-#include <boost/make_shared.hpp>
-#include <boost/dll/shared_library.hpp>
+#include <boost/dll/library_anchor.hpp>
 
 struct library_holding_deleter {
-    boost::shared_ptr<boost::dll::shared_library> lib_;
+    boost::dll::library_anchor_ptr anchor_;
 
     void operator()(my_refcounting_api* p) const {
         delete p;
     }
 };
 
-inline boost::shared_ptr<my_refcounting_api> bind(my_refcounting_api* plugin) {
-    // getting location of the shared library that holds the plugin
-    boost::dll::fs::path location = plugin->location();
-
-    // `make_shared` is an efficient way to create a shared pointer
-    boost::shared_ptr<boost::dll::shared_library> lib
-        = boost::make_shared<boost::dll::shared_library>(location);
-
+inline boost::shared_ptr<my_refcounting_api> bind(my_refcounting_api* plugin,
+    const boost::dll::library_anchor_ptr& anchor)
+{
+    // copying the anchor is a single atomic increment, the library is not loaded again
     library_holding_deleter deleter;
-    deleter.lib_ = lib;
+    deleter.anchor_ = anchor;
 
     return boost::shared_ptr<my_refcounting_api>(
         plugin, deleter
@@ -49,27 +44,28 @@ inline boost::shared_ptr<my_refcounting_api> bind(my_refcounting_api* plugin) {
 //]
 
 //[plugcpp_get_plugin_refcounting
-#include <boost/dll/import.hpp>
-#include <boost/function.hpp>
 inline boost::shared_ptr<my_refcounting_api> get_plugin(
     boost::dll::fs::path path, const char* func_name)
 {
     typedef my_refcounting_api*(func_t)();
-    boost::function<func_t> creator = boost::dll::import_alias<func_t>(
-        path, 
-        func_name, 
+
+    // The only load of the library. Keep the `anchor` to create more plugin
+    // instances without loading the library again.
+    boost::dll::library_anchor_ptr anchor = boost::dll::make_library_anchor(
+        path,
         boost::dll::load_mode::append_decorations   // will be ignored for executable
     );
 
-    // `plugin` does not hold a reference to shared library. If `creator` will go out of scope, 
+    // `plugin` does not hold a reference to shared library. If `anchor` will go out of scope,
     // then `plugin` can not be used.
+    func_t& creator = anchor->library().get_alias<func_t>(func_name);
     my_refcounting_api* plugin = creator();
 
-    // Returned variable holds a reference to 
+    // Returned variable holds a reference to
     // shared_library and it is safe to use it.
-    return bind( plugin );
+    return bind(plugin, anchor);
 
-    // `creator` goes out of scope here and will be destroyed.
+    // `anchor` goes out of scope here, but the library is kept loaded by the returned value.
 }
 
 //]
@@ -0,0 +1,431 @@
+// Copyright 2020 Antony Polukhin.
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt
+// or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BOOST_DLL_ABI_TABLE_HPP
+#define BOOST_DLL_ABI_TABLE_HPP
+
+/// \file boost/dll/abi_table.hpp
+/// \brief Contains the BOOST_DLL_EXPORT_TABLE macro and the boost::dll::import_table functions
+/// that export and import a whole structure of function pointers with a single symbol.
+
+#include <boost/dll/config.hpp>
+#include <boost/dll/shared_library.hpp>
+
+#if defined(BOOST_NO_CXX11_CONSTEXPR) || defined(BOOST_NO_CXX11_VARIADIC_TEMPLATES) || defined(BOOST_NO_CXX11_DECLTYPE)
+#  error This file requires C++11 at least!
+#endif
+
+#include <boost/cstdint.hpp>
+#include <boost/make_shared.hpp>
+#include <boost/move/move.hpp>
+#include <boost/preprocessor/cat.hpp>
+#include <boost/preprocessor/seq/for_each.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/throw_exception.hpp>
+#include <boost/type_traits/alignment_of.hpp>
+
+#include <cstddef>
+#include <string>
+
+#ifdef BOOST_HAS_PRAGMA_ONCE
+# pragma once
+#endif
+
+namespace boost { namespace dll {
+
+/// @cond
+namespace detail {
+
+    // Layout of this structure is a part of the ABI, do not change it.
+    struct abi_table_header {
+        boost::uint32_t magic;
+        boost::uint32_t abi_version;
+        boost::uint32_t size;
+        boost::uint32_t alignment;
+        boost::uint64_t layout_hash;
+        const void*     table;
+    };
+
+    BOOST_STATIC_CONSTANT(boost::uint32_t, abi_table_magic = 0x42444c54u); // "BDLT"
+    BOOST_STATIC_CONSTANT(boost::uint64_t, abi_hash_basis = 14695981039346656037ull);
+
+    // FNV-1a step over the `bytes` low bytes of the value
+    constexpr boost::uint64_t abi_hash_mix(boost::uint64_t hash, boost::uint64_t value, unsigned bytes = 8) {
+        return bytes
+            ? boost::dll::detail::abi_hash_mix((hash ^ (value & 0xffu)) * 1099511628211ull, value >> 8, bytes - 1)
+            : hash;
+    }
+
+    // Encoding of a type that does not depend on the compiler. Names of the user defined types are compiler
+    // specific and those types may be incomplete, so they are all encoded the same way.
+    template <class T>
+    struct abi_type {
+        static constexpr boost::uint64_t mix(boost::uint64_t hash) { return boost::dll::detail::abi_hash_mix(hash, 'U', 1); }
+    };
+
+    template <class... T>
+    struct abi_types {
+        static constexpr boost::uint64_t mix(boost::uint64_t hash) { return hash; }
+    };
+
+    template <class T, class... Rest>
+    struct abi_types<T, Rest...> {
+        static constexpr boost::uint64_t mix(boost::uint64_t hash) {
+            return boost::dll::detail::abi_types<Rest...>::mix(boost::dll::detail::abi_type<T>::mix(hash));
+        }
+    };
+
+#define BOOST_DLL_ABI_TYPE_CODE(Type, Code)                                                          \
+    template <> struct abi_type<Type> {                                                             \
+        static constexpr boost::uint64_t mix(boost::uint64_t hash) {                                \
+            return boost::dll::detail::abi_hash_mix(hash, Code, 1);                                  \
+        }                                                                                           \
+    };                                                                                              \
+    /**/
+
+    BOOST_DLL_ABI_TYPE_CODE(void, 'v')
+    BOOST_DLL_ABI_TYPE_CODE(bool, 'b')
+    BOOST_DLL_ABI_TYPE_CODE(char, 'c')
+    BOOST_DLL_ABI_TYPE_CODE(signed char, 'a')
+    BOOST_DLL_ABI_TYPE_CODE(unsigned char, 'h')
+    BOOST_DLL_ABI_TYPE_CODE(wchar_t, 'w')
+    BOOST_DLL_ABI_TYPE_CODE(char16_t, 'q')
+    BOOST_DLL_ABI_TYPE_CODE(char32_t, 'Q')
+    BOOST_DLL_ABI_TYPE_CODE(short, 's')
+    BOOST_DLL_ABI_TYPE_CODE(unsigned short, 't')
+    BOOST_DLL_ABI_TYPE_CODE(int, 'i')
+    BOOST_DLL_ABI_TYPE_CODE(unsigned int, 'j')
+    BOOST_DLL_ABI_TYPE_CODE(long, 'l')
+    BOOST_DLL_ABI_TYPE_CODE(unsigned long, 'm')
+    BOOST_DLL_ABI_TYPE_CODE(long long, 'x')
+    BOOST_DLL_ABI_TYPE_CODE(unsigned long long, 'y')
+    BOOST_DLL_ABI_TYPE_CODE(float, 'f')
+    BOOST_DLL_ABI_TYPE_CODE(double, 'd')
+    BOOST_DLL_ABI_TYPE_CODE(long double, 'e')
+    BOOST_DLL_ABI_TYPE_CODE(decltype(nullptr), 'n')
+
+#undef BOOST_DLL_ABI_TYPE_CODE
+
+#define BOOST_DLL_ABI_TYPE_COMPOUND(Type, Code)                                                      \
+    template <class T> struct abi_type<Type> {                                                      \
+        static constexpr boost::uint64_t mix(boost::uint64_t hash) {                                \
+            return boost::dll::detail::abi_type<T>::mix(boost::dll::detail::abi_hash_mix(hash, Code, 1)); \
+        }                                                                                           \
+    };                                                                                              \
+    /**/
+
+    BOOST_DLL_ABI_TYPE_COMPOUND(T const, 'K')
+    BOOST_DLL_ABI_TYPE_COMPOUND(T volatile, 'V')
+    BOOST_DLL_ABI_TYPE_COMPOUND(T const volatile, 'W')
+    BOOST_DLL_ABI_TYPE_COMPOUND(T*, 'P')
+    BOOST_DLL_ABI_TYPE_COMPOUND(T&, 'R')
+    BOOST_DLL_ABI_TYPE_COMPOUND(T&&, 'O')
+
+#undef BOOST_DLL_ABI_TYPE_COMPOUND
+
+    template <class T, std::size_t N>
+    struct abi_type<T[N]> {
+        static constexpr boost::uint64_t mix(boost::uint64_t hash) {
+            return boost::dll::detail::abi_type<T>::mix(boost::dll::detail::abi_hash_mix(boost::dll::detail::abi_hash_mix(hash, 'A', 1), N));
+        }
+    };
+
+    template <class R, class... Args>
+    struct abi_type<R(Args...)> {
+        static constexpr boost::uint64_t mix(boost::uint64_t hash) {
+            return boost::dll::detail::abi_hash_mix(
+                boost::dll::detail::abi_types<R, Args...>::mix(boost::dll::detail::abi_hash_mix(hash, 'F', 1)), 'E', 1
+            );
+        }
+    };
+
+    template <class R, class... Args>
+    struct abi_type<R(Args..., ...)> {
+        static constexpr boost::uint64_t mix(boost::uint64_t hash) {
+            return boost::dll::detail::abi_hash_mix(
+                boost::dll::detail::abi_types<R, Args...>::mix(boost::dll::detail::abi_hash_mix(hash, 'F', 1)), 'z', 1
+            );
+        }
+    };
+
+#ifdef __cpp_noexcept_function_type
+    template <class R, class... Args>
+    struct abi_type<R(Args...) noexcept> {
+        static constexpr boost::uint64_t mix(boost::uint64_t hash) {
+            return boost::dll::detail::abi_type<R(Args...)>::mix(hash);
+        }
+    };
+#endif
+
+    // Hash of a member, its type and its offset
+    template <class T>
+    constexpr boost::uint64_t abi_member_hash(std::size_t offset) {
+        return boost::dll::detail::abi_type<T>::mix(boost::dll::detail::abi_hash_mix(abi_hash_basis, offset));
+    }
+
+    constexpr boost::uint64_t abi_layout_hash(boost::uint64_t hash) {
+        return hash;
+    }
+
+    template <class... Members>
+    constexpr boost::uint64_t abi_layout_hash(boost::uint64_t hash, boost::uint64_t member, Members... members) {
+        return boost::dll::detail::abi_layout_hash(boost::dll::detail::abi_hash_mix(hash, member), members...);
+    }
+
+    template <class Iface>
+    constexpr boost::uint64_t abi_table_hash() {
+        // Compilation error at this point means that BOOST_DLL_TABLE_LAYOUT was not used
+        // for the interface.
+        return boost_dll_abi_table_layout(static_cast<const Iface*>(0));
+    }
+
+    // Compilation error at this point means that the implementation passed to the
+    // BOOST_DLL_EXPORT_TABLE is not an object of the interface type.
+    template <class Iface>
+    constexpr boost::dll::detail::abi_table_header make_abi_table_header(const Iface* impl) {
+        return boost::dll::detail::abi_table_header{
+            boost::dll::detail::abi_table_magic,
+            static_cast<boost::uint32_t>(Iface::abi_version),
+            static_cast<boost::uint32_t>(sizeof(Iface)),
+            static_cast<boost::uint32_t>(boost::alignment_of<Iface>::value),
+            boost::dll::detail::abi_table_hash<Iface>(),
+            impl
+        };
+    }
+
+    inline void report_abi_table_error(const boost::dll::fs::error_code& ec, const char* message) {
+        boost::throw_exception(
+            boost::dll::fs::system_error(ec, message)
+        );
+    }
+
+    template <class Iface>
+    inline const Iface* checked_abi_table(const shared_library& lib, const char* name) {
+        const boost::dll::detail::abi_table_header& header = lib.get<const boost::dll::detail::abi_table_header>(name);
+        if (header.magic != boost::dll::detail::abi_table_magic) {
+            boost::dll::detail::report_abi_table_error(
+                boost::dll::fs::make_error_code(boost::dll::fs::errc::invalid_argument),
+                "boost::dll::import_table() failed: symbol is not an ABI table"
+            );
+        }
+
+        if (header.abi_version != static_cast<boost::uint32_t>(Iface::abi_version)) {
+            boost::dll::detail::report_abi_table_error(
+                boost::dll::fs::make_error_code(boost::dll::fs::errc::protocol_not_supported),
+                "boost::dll::import_table() failed: ABI version mismatch"
+            );
+        }
+
+        if (header.size != sizeof(Iface)
+            || header.alignment != boost::alignment_of<Iface>::value
+            || header.layout_hash != boost::dll::detail::abi_table_hash<Iface>())
+        {
+            boost::dll::detail::report_abi_table_error(
+                boost::dll::fs::make_error_code(boost::dll::fs::errc::invalid_argument),
+                "boost::dll::import_table() failed: layout of the table differs from the layout of the interface"
+            );
+        }
+
+        return static_cast<const Iface*>(header.table);
+    }
+} // namespace detail
+/// @endcond
+
+
+/// @cond
+#define BOOST_DLL_TABLE_LAYOUT_MEMBER(r, Iface, Member)                                     \
+    , boost::dll::detail::abi_member_hash<decltype(Iface::Member)>(offsetof(Iface, Member)) \
+    /**/
+/// @endcond
+
+/*!
+* \brief Describes the layout of the structure of function pointers `Iface` for \forcedmacrolink{BOOST_DLL_EXPORT_TABLE}
+* and boost::dll::import_table.
+*
+* The offsets and the types of the listed members are hashed and the hash is checked on import, so adding,
+* removing, reordering or changing the signature of the members is detected. Names of the user defined types
+* are not a part of the hash, because they are spelled differently by different compilers.
+*
+* \param Iface Structure of function pointers.
+* \param Members Preprocessor sequence of all the non static data members of `Iface`, in order of declaration.
+*
+* Must be used in the namespace of `Iface`, in the header that is shared by the host and the plugins.
+*
+* \b Example:
+* \code
+* struct calculator_api {
+*     BOOST_STATIC_CONSTANT(unsigned, abi_version = 1);
+*
+*     int (*add)(int, int);
+*     int (*mul)(int, int);
+* };
+* BOOST_DLL_TABLE_LAYOUT(calculator_api, (add)(mul))
+* \endcode
+*/
+#define BOOST_DLL_TABLE_LAYOUT(Iface, Members)                                              \
+    constexpr boost::uint64_t boost_dll_abi_table_layout(const Iface*) {                    \
+        return boost::dll::detail::abi_layout_hash(boost::dll::detail::abi_hash_basis      \
+            BOOST_PP_SEQ_FOR_EACH(BOOST_DLL_TABLE_LAYOUT_MEMBER, Iface, Members)            \
+        );                                                                                  \
+    }                                                                                       \
+    /**/
+
+
+/*!
+* \brief Exports a constant structure of function pointers `Impl` of type `Iface` as a single symbol
+* with name `TableName`.
+*
+* Together with the table the ABI version `Iface::abi_version`, size, alignment and a hash of the layout
+* from \forcedmacrolink{BOOST_DLL_TABLE_LAYOUT} are exported, so that boost::dll::import_table could check
+* that the plugin was built with the same interface as the host. The exported symbol is constant initialized.
+*
+* \param Iface Structure of function pointers that has an integral static constant `abi_version` and
+*       a layout described by \forcedmacrolink{BOOST_DLL_TABLE_LAYOUT}.
+* \param Impl Object of type `Iface` with static storage duration.
+* \param TableName Name of the exported symbol. Must be a valid C identifier.
+*
+* Must be used in scope where `Impl` is declared, `Impl` must not be a template instance.
+*
+* \b Example:
+* \code
+* // calculator_api.hpp, shared by host and plugins
+* struct calculator_api {
+*     BOOST_STATIC_CONSTANT(unsigned, abi_version = 1);
+*
+*     int (*add)(int, int);
+*     int (*mul)(int, int);
+* };
+* BOOST_DLL_TABLE_LAYOUT(calculator_api, (add)(mul))
+*
+* // plugin.cpp
+* namespace my_namespace {
+*     int add(int a, int b) { return a + b; }
+*     int mul(int a, int b) { return a * b; }
+*     const calculator_api calculator = { &add, &mul };
+* }
+* BOOST_DLL_EXPORT_TABLE_NAMED(calculator_api, my_namespace::calculator, calculator)
+* \endcode
+*/
+#define BOOST_DLL_EXPORT_TABLE_NAMED(Iface, Impl, TableName)                                \
+    namespace _autoaliases { namespace BOOST_PP_CAT(abi_table_, TableName) {                \
+        /* TableName may hide the Iface type name, so the type is captured first */         \
+        typedef Iface iface_type;                                                           \
+        extern "C" BOOST_SYMBOL_EXPORT const boost::dll::detail::abi_table_header TableName; \
+        constexpr boost::dll::detail::abi_table_header TableName                            \
+            = boost::dll::detail::make_abi_table_header<iface_type>(&Impl);                 \
+    }} /**/
+
+
+/*!
+* \brief Same as \forcedmacrolink{BOOST_DLL_EXPORT_TABLE_NAMED} but the table is exported with the
+* name of the interface.
+*
+* \param Iface Structure of function pointers that has an integral static constant `abi_version` and
+*       a layout described by \forcedmacrolink{BOOST_DLL_TABLE_LAYOUT}. Must be an unqualified name that is a valid C identifier.
+* \param Impl Object of type `Iface` with static storage duration.
+*
+* \b Example:
+* \code
+* BOOST_DLL_EXPORT_TABLE(calculator_api, my_namespace::calculator)  // exported as "calculator_api"
+* \endcode
+*/
+#define BOOST_DLL_EXPORT_TABLE(Iface, Impl)                                                 \
+    BOOST_DLL_EXPORT_TABLE_NAMED(Iface, Impl, Iface)                                        \
+    /**/
+
+
+/*!
+* Returns boost::shared_ptr to the structure of function pointers exported by \forcedmacrolink{BOOST_DLL_EXPORT_TABLE}
+* or \forcedmacrolink{BOOST_DLL_EXPORT_TABLE_NAMED}. Returned value refcounts usage of the loaded shared library.
+*
+* Whole interface is bound by a single symbol lookup and a single check of the ABI version and layout,
+* calls go directly through the function pointers of the returned structure.
+*
+* \b Example:
+* \code
+* boost::shared_ptr<const calculator_api> calc
+*     = boost::dll::import_table<calculator_api>("libcalculator.so", "calculator_api");
+* calc->add(1, 2);
+* \endcode
+*
+* \b Template \b parameter \b Iface:    Structure of function pointers with a static constant `abi_version`. Must be explicitly specified.
+*
+* \param lib Path to shared library or shared library to load the table from.
+* \param name Null-terminated name of the table. Can handle std::string, char*, const char*.
+* \param mode An mode that will be used on library load.
+*
+* \return boost::shared_ptr<const Iface> that holds the table.
+*
+* \throw \forcedlinkfs{system_error} if the table does not exist, if the DLL/DSO was not loaded, if the
+*       ABI version differs (\forcedlinkfs{errc}::protocol_not_supported) or if the layout differs.
+*       Overload that accepts path also throws std::bad_alloc in case of insufficient memory.
+*/
+template <class Iface>
+inline boost::shared_ptr<const Iface> import_table(const boost::dll::fs::path& lib, const char* name,
+    load_mode::type mode = load_mode::default_mode)
+{
+    boost::shared_ptr<shared_library> p = boost::make_shared<shared_library>(lib, mode);
+    return boost::shared_ptr<const Iface>(p, boost::dll::detail::checked_abi_table<Iface>(*p, name));
+}
+
+//! \overload boost::dll::import_table(const boost::dll::fs::path& lib, const char* name, load_mode::type mode)
+template <class Iface>
+inline boost::shared_ptr<const Iface> import_table(const boost::dll::fs::path& lib, const std::string& name,
+    load_mode::type mode = load_mode::default_mode)
+{
+    return boost::dll::import_table<Iface>(lib, name.c_str(), mode);
+}
+
+//! \overload boost::dll::import_table(const boost::dll::fs::path& lib, const char* name, load_mode::type mode)
+template <class Iface>
+inline boost::shared_ptr<const Iface> import_table(const shared_library& lib, const char* name) {
+    boost::shared_ptr<shared_library> p = boost::make_shared<shared_library>(lib);
+    return boost::shared_ptr<const Iface>(p, boost::dll::detail::checked_abi_table<Iface>(*p, name));
+}
+
+//! \overload boost::dll::import_table(const boost::dll::fs::path& lib, const char* name, load_mode::type mode)
+template <class Iface>
+inline boost::shared_ptr<const Iface> import_table(const shared_library& lib, const std::string& name) {
+    return boost::dll::import_table<Iface>(lib, name.c_str());
+}
+
+//! \overload boost::dll::import_table(const boost::dll::fs::path& lib, const char* name, load_mode::type mode)
+template <class Iface>
+inline boost::shared_ptr<const Iface> import_table(BOOST_RV_REF(shared_library) lib, const char* name) {
+    boost::shared_ptr<shared_library> p = boost::make_shared<shared_library>(
+        boost::move(lib)
+    );
+    return boost::shared_ptr<const Iface>(p, boost::dll::detail::checked_abi_table<Iface>(*p, name));
+}
+
+//! \overload boost::dll::import_table(const boost::dll::fs::path& lib, const char* name, load_mode::type mode)
+template <class Iface>
+inline boost::shared_ptr<const Iface> import_table(BOOST_RV_REF(shared_library) lib, const std::string& name) {
+    return boost::dll::import_table<Iface>(boost::move(lib), name.c_str());
+}
+
+//! \overload boost::dll::import_table(const boost::dll::fs::path& lib, const char* name, load_mode::type mode)
+template <class Iface>
+inline boost::shared_ptr<const Iface> import_table(const boost::shared_ptr<shared_library>& lib, const char* name) {
+    if (!lib) {
+        boost::dll::detail::report_abi_table_error(
+            boost::dll::fs::make_error_code(boost::dll::fs::errc::bad_file_descriptor),
+            "boost::dll::import_table() failed: empty shared_ptr"
+        );
+    }
+
+    return boost::shared_ptr<const Iface>(lib, boost::dll::detail::checked_abi_table<Iface>(*lib, name));
+}
+
+//! \overload boost::dll::import_table(const boost::dll::fs::path& lib, const char* name, load_mode::type mode)
+template <class Iface>
+inline boost::shared_ptr<const Iface> import_table(const boost::shared_ptr<shared_library>& lib, const std::string& name) {
+    return boost::dll::import_table<Iface>(lib, name.c_str());
+}
+
+}} // boost::dll
+
+#endif // BOOST_DLL_ABI_TABLE_HPP
@@ -183,6 +183,42 @@ namespace boost { namespace dll {
     } /* namespace _autoaliases */                                                              \
     /**/
 #else    
+
+/// @cond
+#if (BOOST_COMP_GNUC || BOOST_COMP_CLANG) && !BOOST_OS_WINDOWS && !BOOST_OS_MACOS && !BOOST_OS_IOS && !defined(BOOST_DLL_DOXYGEN)
+// Describes the section in an ELF note, that boost::dll::section_view() finds in the program headers of
+// the loaded image. Note holds the offsets of the `__start_SectionName` and `__stop_SectionName` symbols
+// that the linker defines, so the note needs no dynamic relocations. Those symbols are hidden, so they are
+// neither exported nor interposed by other modules.
+//
+// Emitted once per translation unit because of the `.ifndef`, and once per binary because of the COMDAT group.
+#define BOOST_DLL_DETAIL_SECTION_BOUNDS(SectionName)                                            \
+        __asm__(                                                                                \
+            ".ifndef .Lboost_dll_section_note_" #SectionName "\n"                               \
+            ".set .Lboost_dll_section_note_" #SectionName ", 1\n"                               \
+            ".hidden __start_" #SectionName "\n"                                                \
+            ".hidden __stop_" #SectionName "\n"                                                 \
+            ".pushsection .note.boostdll,\"aG\",%note,"                                       \
+                "boost_dll_section_note_" #SectionName ",comdat\n"                              \
+            ".balign 4\n"                                                                       \
+            ".long 2f - 1f\n"                                                                   \
+            ".long 4f - 3f\n"                                                                   \
+            ".long 1\n"                                                                         \
+            "1: .asciz \"boostdll\"\n"                                                          \
+            "2: .balign 4\n"                                                                    \
+            "3: .long __start_" #SectionName " - .\n"                                           \
+            ".long __stop_" #SectionName " - .\n"                                               \
+            ".asciz \"" #SectionName "\"\n"                                                     \
+            "4: .balign 4\n"                                                                    \
+            ".popsection\n"                                                                     \
+            ".endif\n"                                                                          \
+        );                                                                                      \
+    /**/
+#else
+#define BOOST_DLL_DETAIL_SECTION_BOUNDS(SectionName)
+#endif
+/// @endcond
+
 // Note: we can not use `aggressive_ptr_cast` here, because in that case GCC applies
 // different permissions to the section and it causes Segmentation fault.
 // Note: we can not use `boost::addressof()` here, because in that case GCC 
@@ -211,6 +247,7 @@ namespace boost { namespace dll {
         const void * AliasName = reinterpret_cast<const void*>(reinterpret_cast<intptr_t>(      \
             &FunctionOrVar                                                                      \
         ));                                                                                     \
+        BOOST_DLL_DETAIL_SECTION_BOUNDS(SectionName)                                            \
     } /* namespace _autoaliases */                                                              \
     /**/
 
@@ -254,6 +291,7 @@ namespace boost { namespace dll {
         extern "C" BOOST_SYMBOL_EXPORT const void *FunctionOrVar;                               \
         BOOST_DLL_SECTION(boostdll, read) BOOST_DLL_SELECTANY                                   \
         const void * FunctionOrVar = dummy_ ## FunctionOrVar;                                   \
+        BOOST_DLL_DETAIL_SECTION_BOUNDS(boostdll)                                               \
     } /* namespace _autoaliases */                                                              \
     /**/
 
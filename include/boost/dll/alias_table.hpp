@@ -0,0 +1,357 @@
+// Copyright 2020 Antony Polukhin.
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt
+// or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BOOST_DLL_ALIAS_TABLE_HPP
+#define BOOST_DLL_ALIAS_TABLE_HPP
+
+/// \file boost/dll/alias_table.hpp
+/// \brief Contains the BOOST_DLL_ALIAS_TABLE_* macro for exporting many aliases with a single symbol
+/// and the boost::dll::alias_table class for resolving them by name without the dynamic linker.
+
+#include <boost/dll/config.hpp>
+#include <boost/dll/shared_library.hpp>
+#include <boost/dll/detail/aggressive_ptr_cast.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/move/move.hpp>
+#include <boost/predef/compiler.h>
+#include <boost/throw_exception.hpp>
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+#if BOOST_COMP_GNUC // MSVC does not have <stdint.h> and defines it in some other header, MinGW requires that header.
+#include <stdint.h> // intptr_t
+#endif
+
+#ifdef BOOST_HAS_PRAGMA_ONCE
+# pragma once
+#endif
+
+namespace boost { namespace dll {
+
+/// @cond
+namespace detail {
+
+    // FNV-1a. Computed at compile time in C++11, so the plugin does not hash its names at runtime.
+    BOOST_CONSTEXPR inline boost::uint64_t alias_table_hash(const char* name, boost::uint64_t hash = 14695981039346656037ull) BOOST_NOEXCEPT {
+        return *name
+            ? boost::dll::detail::alias_table_hash(name + 1, (hash ^ static_cast<unsigned char>(*name)) * 1099511628211ull)
+            : hash;
+    }
+
+    // Layout of those structures is a part of the ABI, do not change them.
+    struct alias_table_entry {
+        boost::uint64_t hash;
+        const char*     name;
+        const void*     address;
+    };
+
+    struct alias_table_header {
+        boost::uint32_t                             magic;
+        boost::uint32_t                             count;
+        const boost::dll::detail::alias_table_entry* entries;
+    };
+
+    BOOST_STATIC_CONSTANT(boost::uint32_t, alias_table_magic = 0x42444c48u); // "BDLH", FNV-1a 64 hashes
+
+} // namespace detail
+/// @endcond
+
+
+/*!
+* \brief Starts a table of aliases that is exported as a single symbol with name `TableName`.
+*
+* Must be followed by one or more \forcedmacrolink{BOOST_DLL_ALIAS_TABLE_ENTRY} and by
+* \forcedmacrolink{BOOST_DLL_ALIAS_TABLE_END} with the same `TableName`. Hashes of the alias names
+* are computed at compile time if the compiler supports C++11 constexpr.
+*
+* \param TableName Name of the exported table. Must be a valid C identifier.
+*
+* \b Example:
+* \code
+* namespace ops {
+*     int add(int, int);
+*     int mul(int, int);
+* }
+*
+* BOOST_DLL_ALIAS_TABLE_BEGIN(operators)
+*     BOOST_DLL_ALIAS_TABLE_ENTRY(ops::add, add)
+*     BOOST_DLL_ALIAS_TABLE_ENTRY(ops::mul, mul)
+* BOOST_DLL_ALIAS_TABLE_END(operators)
+* \endcode
+*/
+#define BOOST_DLL_ALIAS_TABLE_BEGIN(TableName)                                                  \
+    namespace _autoaliases {                                                                    \
+        const boost::dll::detail::alias_table_entry boost_dll_alias_table_ ## TableName[] = {   \
+    /**/
+
+/*!
+* \brief Adds an alias to the table started by \forcedmacrolink{BOOST_DLL_ALIAS_TABLE_BEGIN}.
+*
+* \param FunctionOrVar Function or variable for which an alias must be made. Must be fully qualified.
+* \param AliasName Name of the alias. Must be unique in the table.
+*/
+#define BOOST_DLL_ALIAS_TABLE_ENTRY(FunctionOrVar, AliasName)                                   \
+            {                                                                                   \
+                boost::dll::detail::alias_table_hash(#AliasName),                               \
+                #AliasName,                                                                     \
+                reinterpret_cast<const void*>(reinterpret_cast<intptr_t>(&FunctionOrVar))      \
+            },                                                                                  \
+    /**/
+
+/*!
+* \brief Finishes the table started by \forcedmacrolink{BOOST_DLL_ALIAS_TABLE_BEGIN} and exports it.
+*
+* \param TableName Name of the exported table, same as in \forcedmacrolink{BOOST_DLL_ALIAS_TABLE_BEGIN}.
+*/
+#define BOOST_DLL_ALIAS_TABLE_END(TableName)                                                    \
+        };                                                                                      \
+        extern "C" BOOST_SYMBOL_EXPORT const boost::dll::detail::alias_table_header TableName;  \
+        const boost::dll::detail::alias_table_header TableName = {                              \
+            boost::dll::detail::alias_table_magic,                                              \
+            sizeof(boost_dll_alias_table_ ## TableName)                                         \
+                / sizeof(boost::dll::detail::alias_table_entry),                                \
+            boost_dll_alias_table_ ## TableName                                                 \
+        };                                                                                      \
+    } /* namespace _autoaliases */                                                              \
+    /**/
+
+
+/*!
+* \brief Resolves names from a table exported by \forcedmacrolink{BOOST_DLL_ALIAS_TABLE_BEGIN} in O(1)
+* without calls to the dynamic linker.
+*
+* Construction does a single symbol lookup of the table and builds an open addressing index over the
+* hashes that were computed by the plugin. After that each get() or has() call hashes the name and probes
+* the index. Holds a copy of the boost::dll::shared_library, so the library is not unloaded while
+* the alias_table exists.
+*
+* \b Example:
+* \code
+* boost::dll::alias_table ops(boost::dll::shared_library("libops.so"), "operators");
+* if (ops.has("add")) {
+*     int (&add)(int, int) = ops.get<int(int, int)>("add");
+* }
+* \endcode
+*/
+class alias_table {
+    BOOST_COPYABLE_AND_MOVABLE(alias_table)
+
+    boost::dll::shared_library                      lib_;
+    const boost::dll::detail::alias_table_entry*    entries_;
+    std::size_t                                     count_;
+    std::vector<boost::uint32_t>                    index_; // Indexes in `entries_` plus one, zero for empty slots
+
+    void init(const char* table_name) {
+        const boost::dll::detail::alias_table_header& header = lib_.get<const boost::dll::detail::alias_table_header>(table_name);
+        if (header.magic != boost::dll::detail::alias_table_magic) {
+            boost::throw_exception(
+                boost::dll::fs::system_error(
+                    boost::dll::fs::make_error_code(boost::dll::fs::errc::invalid_argument),
+                    "boost::dll::alias_table() failed: symbol is not an alias table"
+                )
+            );
+        }
+
+        entries_ = header.entries;
+        count_ = header.count;
+
+        std::size_t size = 4;
+        while (size < count_ * 2) {
+            size *= 2;
+        }
+
+        index_.assign(size, 0);
+        for (std::size_t i = 0; i < count_; ++i) {
+            std::size_t slot = static_cast<std::size_t>(entries_[i].hash) & (size - 1);
+            while (index_[slot]) {
+                slot = (slot + 1) & (size - 1);
+            }
+            index_[slot] = static_cast<boost::uint32_t>(i + 1);
+        }
+    }
+
+    const boost::dll::detail::alias_table_entry* find(const char* name) const BOOST_NOEXCEPT {
+        if (index_.empty()) {
+            return 0;
+        }
+
+        const boost::uint64_t hash = boost::dll::detail::alias_table_hash(name);
+        const std::size_t mask = index_.size() - 1;
+        for (std::size_t slot = static_cast<std::size_t>(hash) & mask; index_[slot]; slot = (slot + 1) & mask) {
+            const boost::dll::detail::alias_table_entry& e = entries_[index_[slot] - 1];
+            if (e.hash == hash && !std::strcmp(e.name, name)) {
+                return &e;
+            }
+        }
+
+        return 0;
+    }
+
+public:
+    /*!
+    * Creates an empty table.
+    *
+    * \throw Nothing.
+    */
+    alias_table() BOOST_NOEXCEPT
+        : entries_(0)
+        , count_(0)
+    {}
+
+    /*!
+    * Binds the table `table_name` from the library `lib`.
+    *
+    * \param lib Library that exports the table.
+    * \param table_name Null-terminated name of the table. Can handle std::string, char*, const char*.
+    * \throw \forcedlinkfs{system_error} if the table does not exist or if the DLL/DSO was not loaded,
+    *       std::bad_alloc in case of insufficient memory.
+    */
+    alias_table(const boost::dll::shared_library& lib, const char* table_name)
+        : lib_(lib)
+        , entries_(0)
+        , count_(0)
+    {
+        init(table_name);
+    }
+
+    //! \overload alias_table(const boost::dll::shared_library& lib, const char* table_name)
+    alias_table(const boost::dll::shared_library& lib, const std::string& table_name)
+        : lib_(lib)
+        , entries_(0)
+        , count_(0)
+    {
+        init(table_name.c_str());
+    }
+
+    //! \overload alias_table(const boost::dll::shared_library& lib, const char* table_name)
+    alias_table(BOOST_RV_REF(boost::dll::shared_library) lib, const char* table_name)
+        : lib_(boost::move(lib))
+        , entries_(0)
+        , count_(0)
+    {
+        init(table_name);
+    }
+
+    //! \overload alias_table(const boost::dll::shared_library& lib, const char* table_name)
+    alias_table(BOOST_RV_REF(boost::dll::shared_library) lib, const std::string& table_name)
+        : lib_(boost::move(lib))
+        , entries_(0)
+        , count_(0)
+    {
+        init(table_name.c_str());
+    }
+
+    /// Copy constructor, copies the library.
+    alias_table(const alias_table& t)
+        : lib_(t.lib_)
+        , entries_(t.entries_)
+        , count_(t.count_)
+        , index_(t.index_)
+    {}
+
+    /// Move constructor.
+    alias_table(BOOST_RV_REF(alias_table) t) BOOST_NOEXCEPT
+        : lib_(boost::move(t.lib_))
+        , entries_(t.entries_)
+        , count_(t.count_)
+    {
+        index_.swap(t.index_);
+        t.entries_ = 0;
+        t.count_ = 0;
+    }
+
+    /// Copy assignment.
+    alias_table& operator=(BOOST_COPY_ASSIGN_REF(alias_table) t) {
+        alias_table tmp(t);
+        swap(tmp);
+        return *this;
+    }
+
+    /// Move assignment.
+    alias_table& operator=(BOOST_RV_REF(alias_table) t) BOOST_NOEXCEPT {
+        alias_table tmp(boost::move(t));
+        swap(tmp);
+        return *this;
+    }
+
+    /// Swaps two tables.
+    void swap(alias_table& t) BOOST_NOEXCEPT {
+        lib_.swap(t.lib_);
+        std::swap(entries_, t.entries_);
+        std::swap(count_, t.count_);
+        index_.swap(t.index_);
+    }
+
+    /// \return Library that holds the table.
+    const boost::dll::shared_library& library() const BOOST_NOEXCEPT {
+        return lib_;
+    }
+
+    /// \return Count of the aliases in the table.
+    std::size_t size() const BOOST_NOEXCEPT {
+        return count_;
+    }
+
+    /// \return Name of the alias with index `i`, where `i < size()`.
+    const char* name(std::size_t i) const BOOST_NOEXCEPT {
+        return entries_[i].name;
+    }
+
+    /*!
+    * \param alias_name Null-terminated alias name. Can handle std::string, char*, const char*.
+    * \return true if the table has an alias with such name.
+    * \throw Nothing.
+    */
+    bool has(const char* alias_name) const BOOST_NOEXCEPT {
+        return !!find(alias_name);
+    }
+
+    //! \overload bool has(const char* alias_name) const
+    bool has(const std::string& alias_name) const BOOST_NOEXCEPT {
+        return has(alias_name.c_str());
+    }
+
+    /*!
+    * Returns a reference to the aliased function or variable. Same semantics as
+    * boost::dll::shared_library::get_alias.
+    *
+    * \tparam T Type of the aliased symbol. Must be explicitly specified.
+    * \param alias_name Null-terminated alias name. Can handle std::string, char*, const char*.
+    * \return Reference to the symbol.
+    * \throw \forcedlinkfs{system_error} if there is no such alias in the table.
+    */
+    template <class T>
+    T& get(const char* alias_name) const {
+        const boost::dll::detail::alias_table_entry* const e = find(alias_name);
+        if (!e) {
+            boost::throw_exception(
+                boost::dll::fs::system_error(
+                    boost::dll::fs::make_error_code(boost::dll::fs::errc::invalid_argument),
+                    "boost::dll::alias_table::get() failed: no such alias in the table"
+                )
+            );
+        }
+
+        return *boost::dll::detail::aggressive_ptr_cast<T*>(const_cast<void*>(e->address));
+    }
+
+    //! \overload T& get(const char* alias_name) const
+    template <class T>
+    T& get(const std::string& alias_name) const {
+        return get<T>(alias_name.c_str());
+    }
+};
+
+/// Swaps two tables.
+inline void swap(alias_table& lhs, alias_table& rhs) BOOST_NOEXCEPT {
+    lhs.swap(rhs);
+}
+
+}} // boost::dll
+
+#endif // BOOST_DLL_ALIAS_TABLE_HPP
@@ -19,6 +19,10 @@
 /// Define this macro to make Boost.DLL use C++17's std::filesystem::path, std::system_error and std::error_code.
 #define BOOST_DLL_USE_STD_FS BOOST_DLL_USE_STD_FS
 
+/// Define this macro to make Boost.DLL report library loads, unloads and symbol lookups to the boost::dll::lifecycle_observer.
+/// Requires C++11. Without this macro no tracing code is compiled.
+#define BOOST_DLL_ENABLE_TRACING BOOST_DLL_ENABLE_TRACING
+
 /// This namespace contains aliases to the Boost or C++17 classes. Aliases are configured using BOOST_DLL_USE_STD_FS macro.
 namespace boost { namespace dll { namespace fs {
 
@@ -8,6 +8,7 @@
 #define BOOST_DLL_DETAIL_DEMANGLING_ITANIUM_HPP_
 
 #include <boost/dll/detail/demangling/mangled_storage_base.hpp>
+#include <boost/dll/detail/demangling/itanium_mangler.hpp>
 #include <iterator>
 #include <algorithm>
 #include <boost/type_traits/is_const.hpp>
@@ -61,27 +62,73 @@ public:
         }
     };
 
+    // Lookups are memoized, repeated calls with the same arguments do not search the symbols again.
     template<typename T>
-    std::string get_variable(const std::string &name) const;
+    std::string get_variable(const std::string &name) const
+    {
+        return memoized<std::string, T>('v', name, [&]{ return find_variable<T>(name); });
+    }
 
     template<typename Func>
-    std::string get_function(const std::string &name) const;
+    std::string get_function(const std::string &name) const
+    {
+        return memoized<std::string, Func>('f', name, [&]{ return find_function<Func>(name); });
+    }
 
     template<typename Class, typename Func>
-    std::string get_mem_fn(const std::string &name) const;
+    std::string get_mem_fn(const std::string &name) const
+    {
+        return memoized<std::string, Class, Func>('m', name, [&]{ return find_mem_fn<Class, Func>(name); });
+    }
 
     template<typename Signature>
-    ctor_sym get_constructor() const;
+    ctor_sym get_constructor() const
+    {
+        return memoized<ctor_sym, Signature>('c', std::string(), [&]{ return find_constructor<Signature>(); });
+    }
 
     template<typename Class>
-    dtor_sym get_destructor() const;
+    dtor_sym get_destructor() const
+    {
+        return memoized<dtor_sym, Class>('d', std::string(), [&]{ return find_destructor<Class>(); });
+    }
+
+    template<typename T>
+    std::string get_type_info() const
+    {
+        return memoized<std::string, T>('t', std::string(), [&]{ return find_type_info<T>(); });
+    }
 
     template<typename T>
-    std::string get_type_info() const;
+    std::string get_vtable() const
+    {
+        return memoized<std::string, T>('V', std::string(), [&]{ return find_vtable<T>(); });
+    }
 
     template<typename T>
     std::vector<std::string> get_related() const;
 
+private:
+    template<typename T>
+    std::string find_variable(const std::string &name) const;
+
+    template<typename Func>
+    std::string find_function(const std::string &name) const;
+
+    template<typename Class, typename Func>
+    std::string find_mem_fn(const std::string &name) const;
+
+    template<typename Signature>
+    auto find_constructor() const -> ctor_sym;
+
+    template<typename Class>
+    auto find_destructor() const -> dtor_sym;
+
+    template<typename T>
+    std::string find_type_info() const;
+
+    template<typename T>
+    std::string find_vtable() const;
 };
 
 
@@ -290,84 +337,108 @@ namespace parser
 
 
 
-template<typename T> std::string mangled_storage_impl::get_variable(const std::string &name) const
+template<typename T> std::string mangled_storage_impl::find_variable(const std::string &name) const
 {
-    auto found = std::find_if(storage_.begin(), storage_.end(),
-            [&](const entry& e) {return e.demangled == name;});
-
-    if (found != storage_.end())
-        return found->mangled;
-    else
-        return "";
+    return find_mangled(name);
 }
 
-template<typename Func> std::string mangled_storage_impl::get_function(const std::string &name) const
+template<typename Func> std::string mangled_storage_impl::find_function(const std::string &name) const
 {
     using func_type = Func*;
 
-    auto matcher = name + '(' + parser::arg_list(*this, func_type()) + ')';
-
-    auto found = std::find_if(storage_.begin(), storage_.end(), [&](const entry& e) {return e.demangled == matcher;});
-    if (found != storage_.end())
-        return found->mangled;
-    else
-        return "";
+    // The demangled matcher is built only if the mangled name is not in the table
+    const auto mangled = itanium_mangler(*this).function<Func>(name);
+    if (!mangled.empty() && has_mangled(mangled))
+        return mangled;
 
+    return find_mangled(name + '(' + parser::arg_list(*this, func_type()) + ')');
 }
 
 template<typename Class, typename Func>
-std::string mangled_storage_impl::get_mem_fn(const std::string &name) const
+std::string mangled_storage_impl::find_mem_fn(const std::string &name) const
 {
     using namespace parser;
 
     using func_type = Func*;
 
+    const auto mangled = itanium_mangler(*this).mem_fn<Class, Func>(name);
+    if (!mangled.empty() && has_mangled(mangled))
+        return mangled;
+
     std::string cname = get_name<Class>();
 
     const auto matcher = cname + "::" + name +
              '(' + parser::arg_list(*this, func_type()) + ')'
              + const_rule<Class>() + volatile_rule<Class>();
 
+    std::string member;
+    for_each_class_symbol(cname, 'm', name, [&matcher, &member](const symbol& e) {
+        if (member.empty() && e.demangled == matcher)
+            member = e.mangled.to_string();
+    });
+    if (!member.empty())
+        return member;
+
+    auto exact = find_mangled(matcher);
+    if (!exact.empty())
+        return exact;
+
     // Linux export table contains int MyClass::Func<float>(), but expected in import_mangled MyClass::Func<float>() without returned type.
-    auto found = std::find_if(storage_.begin(), storage_.end(), [&matcher](const entry& e) {
-        if (e.demangled == matcher) {
-          return true;
+    // Only template functions have the return type in the demangled name, so the matcher must end with '>' before the arguments.
+    if (name.empty() || name.back() != '>')
+        return "";
+
+    std::string found;
+    for_each_candidate(matcher, [&matcher, &found](const symbol& e) {
+        if (!found.empty() || e.demangled.size() <= matcher.size()) {
+          return;
         }
 
         const auto pos = e.demangled.rfind(matcher);
         if (pos == std::string::npos) {
           // Not found.
-          return false;
+          return;
         }
 
         if (pos + matcher.size() != e.demangled.size()) {
           // There are some characters after the `matcher` string.
-          return false;
+          return;
         }
 
         // Double checking that we matched a full function name
-        return e.demangled[pos - 1] == ' '; // `if (e.demangled == matcher)` makes sure that `pos > 0`
+        if (e.demangled[pos - 1] == ' ') { // `e.demangled.size() > matcher.size()` makes sure that `pos > 0`
+          found = e.mangled.to_string();
+        }
     });
 
-    if (found != storage_.end())
-        return found->mangled;
-    else
-        return "";
+    return found;
 
 }
 
 
 template<typename Signature>
-auto mangled_storage_impl::get_constructor() const -> ctor_sym
+auto mangled_storage_impl::find_constructor() const -> ctor_sym
 {
     using namespace parser;
 
     using func_type = Signature*;
 
+    ctor_sym ct;
+
+    itanium_mangler mangler(*this);
+    const auto c1 = mangler.constructor<Signature>("C1");
+    const auto c2 = mangler.constructor<Signature>("C2");
+    const auto c3 = mangler.constructor<Signature>("C3");
+    if (!c1.empty() && has_mangled(c1)) ct.C1 = c1;
+    if (!c2.empty() && has_mangled(c2)) ct.C2 = c2;
+    if (!c3.empty() && has_mangled(c3)) ct.C3 = c3;
+    if (!ct.empty())
+        return ct;
+
+    const auto class_name = get_return_type(dummy<Signature>());
     std::string ctor_name; // = class_name + "::" + name;
     std::string unscoped_cname; //the unscoped class-name
     {
-        auto class_name = get_return_type(dummy<Signature>());
         auto pos = class_name.rfind("::");
         if (pos == std::string::npos)
         {
@@ -384,33 +455,44 @@ auto mangled_storage_impl::get_constructor() const -> ctor_sym
     auto matcher =
                 ctor_name + '(' + parser::arg_list(*this, func_type()) + ')';
 
-
-    std::vector<entry> findings;
-    std::copy_if(storage_.begin(), storage_.end(),
-            std::back_inserter(findings), [&](const entry& e) {return e.demangled == matcher;});
-
-    ctor_sym ct;
-
-    for (auto & e : findings)
+    auto assign = [&](const symbol& e)
     {
+        if (e.demangled != matcher)
+            return;
+
+        if (e.mangled.find(unscoped_cname +"C1E") != boost::string_view::npos)
+            ct.C1 = e.mangled.to_string();
+        else if (e.mangled.find(unscoped_cname +"C2E") != boost::string_view::npos)
+            ct.C2 = e.mangled.to_string();
+        else if (e.mangled.find(unscoped_cname +"C3E") != boost::string_view::npos)
+            ct.C3 = e.mangled.to_string();
+    };
 
-        if (e.mangled.find(unscoped_cname +"C1E") != std::string::npos)
-            ct.C1 = e.mangled;
-        else if (e.mangled.find(unscoped_cname +"C2E") != std::string::npos)
-            ct.C2 = e.mangled;
-        else if (e.mangled.find(unscoped_cname +"C3E") != std::string::npos)
-            ct.C3 = e.mangled;
-    }
+    for_each_class_symbol(class_name, 'c', boost::string_view(), assign);
+    if (ct.empty())
+        for_each_demangled(matcher, assign);
     return ct;
 }
 
 template<typename Class>
-auto mangled_storage_impl::get_destructor() const -> dtor_sym
+auto mangled_storage_impl::find_destructor() const -> dtor_sym
 {
+    dtor_sym dt;
+
+    itanium_mangler mangler(*this);
+    const auto m0 = mangler.destructor<Class>("D0");
+    const auto m1 = mangler.destructor<Class>("D1");
+    const auto m2 = mangler.destructor<Class>("D2");
+    if (!m0.empty() && has_mangled(m0)) dt.D0 = m0;
+    if (!m1.empty() && has_mangled(m1)) dt.D1 = m1;
+    if (!m2.empty() && has_mangled(m2)) dt.D2 = m2;
+    if (!dt.empty())
+        return dt;
+
+    const auto class_name = get_name<Class>();
     std::string dtor_name; // = class_name + "::" + name;
     std::string unscoped_cname; //the unscoped class-name
     {
-        auto class_name = get_name<Class>();
         auto pos = class_name.rfind("::");
         if (pos == std::string::npos)
         {
@@ -428,44 +510,58 @@ auto mangled_storage_impl::get_destructor() const -> dtor_sym
     auto d1 = unscoped_cname + "D1Ev";
     auto d2 = unscoped_cname + "D2Ev";
 
-    dtor_sym dt;
-    //this is so simple, i don#t need a predicate
-    for (auto & s : storage_)
+    auto assign = [&](const symbol& s)
     {
-        //alright, name fits
-        if (s.demangled == dtor_name)
-        {
-            if (s.mangled.find(d0) != std::string::npos)
-                dt.D0 = s.mangled;
-            else if (s.mangled.find(d1) != std::string::npos)
-                dt.D1 = s.mangled;
-            else if (s.mangled.find(d2) != std::string::npos)
-                dt.D2 = s.mangled;
+        if (s.demangled != dtor_name)
+            return;
+
+        if (s.mangled.find(d0) != boost::string_view::npos)
+            dt.D0 = s.mangled.to_string();
+        else if (s.mangled.find(d1) != boost::string_view::npos)
+            dt.D1 = s.mangled.to_string();
+        else if (s.mangled.find(d2) != boost::string_view::npos)
+            dt.D2 = s.mangled.to_string();
+    };
 
-        }
-    }
+    for_each_class_symbol(class_name, 'd', boost::string_view(), assign);
+    if (dt.empty())
+        for_each_demangled(dtor_name, assign);
     return dt;
 
 }
 
 template<typename T>
-std::string mangled_storage_impl::get_type_info() const
+std::string mangled_storage_impl::find_type_info() const
 {
-    std::string id = "typeinfo for " + get_name<T>();
+    const auto class_name = get_name<T>();
+    std::string id = "typeinfo for " + class_name;
 
+    std::string found;
+    for_each_class_symbol(class_name, 't', boost::string_view(), [&id, &found](const symbol& s) {
+        if (s.demangled == id)
+            found = s.mangled.to_string();
+    });
+    if (!found.empty())
+        return found;
 
-    auto predicate = [&](const mangled_storage_base::entry & e)
-                {
-                    return e.demangled == id;
-                };
+    return find_mangled(id);
+}
 
-    auto found = std::find_if(storage_.begin(), storage_.end(), predicate);
+template<typename T>
+std::string mangled_storage_impl::find_vtable() const
+{
+    const auto class_name = get_name<T>();
+    std::string id = "vtable for " + class_name;
 
+    std::string found;
+    for_each_class_symbol(class_name, 'v', boost::string_view(), [&id, &found](const symbol& s) {
+        if (s.demangled == id)
+            found = s.mangled.to_string();
+    });
+    if (!found.empty())
+        return found;
 
-    if (found != storage_.end())
-        return found->mangled;
-    else
-        return "";
+    return find_mangled(id);
 }
 
 template<typename T>
@@ -474,11 +570,10 @@ std::vector<std::string> mangled_storage_impl::get_related()  const
     std::vector<std::string> ret;
     auto name = get_name<T>();
 
-    for (auto & c : storage_)
+    for_each_containing(name, [&ret](const symbol& c)
     {
-        if (c.demangled.find(name) != std::string::npos)
-            ret.push_back(c.demangled);
-    }
+        ret.push_back(c.demangled.to_string());
+    });
 
     return ret;
 }
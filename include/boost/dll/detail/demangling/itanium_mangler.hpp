@@ -0,0 +1,328 @@
+// Copyright 2020 Antony Polukhin.
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt
+// or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BOOST_DLL_DETAIL_DEMANGLING_ITANIUM_MANGLER_HPP_
+#define BOOST_DLL_DETAIL_DEMANGLING_ITANIUM_MANGLER_HPP_
+
+#include <boost/dll/detail/demangling/mangled_storage_base.hpp>
+#include <boost/type_traits/is_class.hpp>
+#include <boost/type_traits/is_const.hpp>
+#include <boost/type_traits/is_enum.hpp>
+#include <boost/type_traits/is_union.hpp>
+#include <boost/type_traits/is_volatile.hpp>
+#include <boost/type_traits/remove_cv.hpp>
+#include <boost/type_traits/remove_reference.hpp>
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#ifdef BOOST_HAS_PRAGMA_ONCE
+# pragma once
+#endif
+
+namespace boost { namespace dll { namespace detail {
+
+// Produces the Itanium C++ ABI mangled names of functions, member functions, constructors and destructors
+// from the C++ types and the name, without looking at the symbols of the library.
+//
+// Only non template entities from named namespaces are supported, with the parameters of fundamental, class
+// or enum types and the pointers, references and cv-qualified versions of those. The class names are taken
+// from mangled_storage_base::get_name(), so the aliases are respected. For anything else (templates, std::,
+// function pointers, arrays, operators...) an empty string is returned and the caller must fall back to
+// the lookup by the demangled name. The result is only a guess: ABI tags or other attributes that are not
+// visible in the type change the real name, so the caller has to check that the symbol exists.
+class itanium_mangler {
+    template <class T>
+    struct tag {};
+
+    const mangled_storage_base& ms_;
+    std::string out_;
+    // Keys of the substitution candidates in order of appearance. Names are keyed as "N" + qualified name,
+    // qualified types as the qualifier codes followed by the key of the underlying type.
+    std::vector<std::string> substitutions_;
+    bool ok_ = true;
+
+    static bool is_identifier(const std::string& s) {
+        if (s.empty() || (s[0] >= '0' && s[0] <= '9')) {
+            return false;
+        }
+        for (char c : s) {
+            if (!(c == '_' || (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9'))) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Splits "a::b::c" into the components. Returns false for names that are not plain identifiers or
+    // that are in the std namespace, which has its own abbreviations.
+    static bool split(const std::string& name, std::vector<std::string>& out) {
+        out.clear();
+        std::size_t pos = 0;
+        for (;;) {
+            const std::size_t next = name.find("::", pos);
+            out.push_back(name.substr(pos, next == std::string::npos ? std::string::npos : next - pos));
+            if (!is_identifier(out.back())) {
+                return false;
+            }
+            if (next == std::string::npos) {
+                break;
+            }
+            pos = next + 2;
+        }
+        return out.front() != "std";
+    }
+
+    static std::string source_name(const std::string& id) {
+        return std::to_string(id.size()) + id;
+    }
+
+    // Emits the substitution for the key if it was seen before.
+    bool substitute(const std::string& key) {
+        for (std::size_t i = 0; i < substitutions_.size(); ++i) {
+            if (substitutions_[i] != key) {
+                continue;
+            }
+
+            out_ += 'S';
+            if (i) {
+                std::string seq_id;
+                for (std::size_t n = i - 1; ; n /= 36) {
+                    const std::size_t digit = n % 36;
+                    seq_id.insert(seq_id.begin(), static_cast<char>(digit < 10 ? '0' + digit : 'A' + digit - 10));
+                    if (n < 36) {
+                        break;
+                    }
+                }
+                out_ += seq_id;
+            }
+            out_ += '_';
+            return true;
+        }
+        return false;
+    }
+
+    void class_name(const std::string& name) {
+        std::vector<std::string> parts;
+        if (!split(name, parts)) {
+            ok_ = false;
+            return;
+        }
+
+        std::vector<std::string> keys;
+        std::string key = "N";
+        for (auto& p : parts) {
+            if (key.size() > 1) {
+                key += "::";
+            }
+            key += p;
+            keys.push_back(key);
+        }
+
+        if (parts.size() == 1) {
+            if (!substitute(keys[0])) {
+                out_ += source_name(parts[0]);
+                substitutions_.push_back(keys[0]);
+            }
+            return;
+        }
+
+        // The longest already seen prefix is substituted, the rest is written out
+        std::size_t first = parts.size();
+        for (; first > 0; --first) {
+            std::size_t mark = out_.size();
+            if (substitute(keys[first - 1])) {
+                if (first == parts.size()) {
+                    return;
+                }
+                out_.insert(mark, 1, 'N');
+                break;
+            }
+        }
+        if (first == 0) {
+            out_ += 'N';
+        }
+        for (std::size_t i = first; i < parts.size(); ++i) {
+            out_ += source_name(parts[i]);
+            substitutions_.push_back(keys[i]);
+        }
+        out_ += 'E';
+    }
+
+    static const char* builtin(tag<void>)                { return "v"; }
+    static const char* builtin(tag<bool>)                { return "b"; }
+    static const char* builtin(tag<char>)                { return "c"; }
+    static const char* builtin(tag<signed char>)         { return "a"; }
+    static const char* builtin(tag<unsigned char>)       { return "h"; }
+    static const char* builtin(tag<wchar_t>)             { return "w"; }
+    static const char* builtin(tag<char16_t>)            { return "Ds"; }
+    static const char* builtin(tag<char32_t>)            { return "Di"; }
+    static const char* builtin(tag<short>)               { return "s"; }
+    static const char* builtin(tag<unsigned short>)      { return "t"; }
+    static const char* builtin(tag<int>)                 { return "i"; }
+    static const char* builtin(tag<unsigned int>)        { return "j"; }
+    static const char* builtin(tag<long>)                { return "l"; }
+    static const char* builtin(tag<unsigned long>)       { return "m"; }
+    static const char* builtin(tag<long long>)           { return "x"; }
+    static const char* builtin(tag<unsigned long long>)  { return "y"; }
+    static const char* builtin(tag<float>)               { return "f"; }
+    static const char* builtin(tag<double>)              { return "d"; }
+    static const char* builtin(tag<long double>)         { return "e"; }
+    static const char* builtin(tag<decltype(nullptr)>)   { return "Dn"; }
+    template <class T>
+    static const char* builtin(tag<T>)                   { return nullptr; }
+
+    template <class T>
+    std::string key(tag<T>) const {
+        const char* code = builtin(tag<T>());
+        return code ? std::string(code) : "N" + ms_.get_name<T>();
+    }
+    template <class T> std::string key(tag<T const>) const           { return "K"  + key(tag<T>()); }
+    template <class T> std::string key(tag<T volatile>) const        { return "V"  + key(tag<T>()); }
+    template <class T> std::string key(tag<T const volatile>) const  { return "VK" + key(tag<T>()); }
+    template <class T> std::string key(tag<T*>) const                { return "P"  + key(tag<T>()); }
+    template <class T> std::string key(tag<T&>) const                { return "R"  + key(tag<T>()); }
+    template <class T> std::string key(tag<T&&>) const               { return "O"  + key(tag<T>()); }
+
+    template <class T>
+    void type(tag<T>) {
+        const char* code = builtin(tag<T>());
+        if (code) {
+            out_ += code;
+        } else if (boost::is_class<T>::value || boost::is_union<T>::value || boost::is_enum<T>::value) {
+            class_name(ms_.get_name<T>());
+        } else {
+            ok_ = false;
+        }
+    }
+    template <class T> void type(tag<T const>)           { qualified<T>("K"); }
+    template <class T> void type(tag<T volatile>)        { qualified<T>("V"); }
+    template <class T> void type(tag<T const volatile>)  { qualified<T>("VK"); }
+    template <class T> void type(tag<T*>)                { qualified<T>("P"); }
+    template <class T> void type(tag<T&>)                { qualified<T>("R"); }
+    template <class T> void type(tag<T&&>)               { qualified<T>("O"); }
+
+    template <class T>
+    void qualified(const char* qualifier) {
+        const std::string k = qualifier + key(tag<T>());
+        if (substitute(k)) {
+            return;
+        }
+        out_ += qualifier;
+        type(tag<T>());
+        substitutions_.push_back(k);
+    }
+
+    // The top level cv-qualifiers of the parameters are not part of the signature
+    template <class R>
+    void params(tag<R()>) {
+        out_ += 'v';
+    }
+    template <class R, class... Args>
+    void params(tag<R(Args...)>) {
+        const int expand[] = {(type(tag<typename boost::remove_cv<Args>::type>()), 0)...};
+        (void)expand;
+    }
+
+    void encoding(const std::vector<std::string>& scope, const std::string& unqualified, const char* cv) {
+        out_ = "_Z";
+        if (scope.empty()) {
+            out_ += unqualified;
+            return;
+        }
+
+        out_ += 'N';
+        out_ += cv;
+        std::string key = "N";
+        for (auto& s : scope) {
+            if (key.size() > 1) {
+                key += "::";
+            }
+            key += s;
+            out_ += source_name(s);
+            substitutions_.push_back(key);
+        }
+        out_ += unqualified;
+        out_ += 'E';
+    }
+
+    template <class Func>
+    std::string finish(const std::vector<std::string>& scope, const std::string& unqualified, const char* cv) {
+        encoding(scope, unqualified, cv);
+        params(tag<Func>());
+
+        std::string result;
+        if (ok_) {
+            result.swap(out_);
+        }
+        out_.clear();
+        substitutions_.clear();
+        ok_ = true;
+        return result;
+    }
+
+    template <class Class, class... Args>
+    std::string constructor_impl(tag<Class(Args...)>, const char* kind) {
+        std::vector<std::string> scope;
+        if (!split(ms_.get_name<Class>(), scope)) {
+            return std::string();
+        }
+        return finish<void(Args...)>(scope, kind, "");
+    }
+
+public:
+    explicit itanium_mangler(const mangled_storage_base& ms) noexcept
+        : ms_(ms)
+    {}
+
+    // Mangled name of the function `name` with the signature `Func`.
+    template <class Func>
+    std::string function(const std::string& name) {
+        std::vector<std::string> scope;
+        if (!split(name, scope)) {
+            return std::string();
+        }
+        const std::string unqualified = source_name(scope.back());
+        scope.pop_back();
+        return finish<Func>(scope, unqualified, "");
+    }
+
+    // Mangled name of the member function `name` of `Class` with the signature `Func`, `Class` may be cv-qualified.
+    template <class Class, class Func>
+    std::string mem_fn(const std::string& name) {
+        std::vector<std::string> scope;
+        if (!is_identifier(name) || !split(ms_.get_name<Class>(), scope)) {
+            return std::string();
+        }
+
+        using class_type = typename boost::remove_reference<Class>::type;
+        const char* cv = boost::is_const<class_type>::value
+            ? (boost::is_volatile<class_type>::value ? "VK" : "K")
+            : (boost::is_volatile<class_type>::value ? "V" : "");
+        return finish<Func>(scope, source_name(name), cv);
+    }
+
+    // Mangled name of the constructor with the `Class(Args...)` signature, kind is "C1", "C2" or "C3".
+    template <class Signature>
+    std::string constructor(const char* kind) {
+        return constructor_impl(tag<Signature>(), kind);
+    }
+
+    // Mangled name of the destructor of `Class`, kind is "D0", "D1" or "D2".
+    template <class Class>
+    std::string destructor(const char* kind) {
+        std::vector<std::string> scope;
+        if (!split(ms_.get_name<Class>(), scope)) {
+            return std::string();
+        }
+        return finish<void()>(scope, kind, "");
+    }
+};
+
+}}} // namespace boost::dll::detail
+
+#endif // BOOST_DLL_DETAIL_DEMANGLING_ITANIUM_MANGLER_HPP_
@@ -10,10 +10,27 @@
 #include <vector>
 #include <string>
 #include <map>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <exception>
+#include <functional>
+#include <tuple>
+#include <unordered_map>
+#include <algorithm>
 #include <boost/dll/detail/demangling/demangle_symbol.hpp>
+#include <boost/dll/detail/demangling/string_arena.hpp>
 #include <boost/dll/library_info.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/iterator/iterator_facade.hpp>
 #include <boost/type_index/ctti_type_index.hpp>
 #include <boost/type_traits/remove_reference.hpp>
+#include <boost/utility/string_view.hpp>
+
+#ifdef BOOST_DLL_ENABLE_TRACING
+#   include <boost/dll/detail/lifecycle_trace.hpp>
+#endif
 
 namespace boost { namespace dll { namespace detail {
 
@@ -31,58 +48,1162 @@ struct mangled_storage_base
         entry &operator= (const entry&) = default;
         entry &operator= (entry&&)         = default;
     };
+
+    ///names of a symbol stored in the arena. Empty demangled name means that the symbol was not demangled yet.
+    struct symbol
+    {
+        boost::string_view mangled;
+        boost::string_view demangled;
+    };
 protected:
-    std::vector<entry> storage_;
-    ///if a unknown class is imported it can be overloaded by this type
-    std::map<boost::typeindex::ctti_type_index, std::string> aliases_;
+#if defined(_MSC_VER)
+    ///MSVC mangled names are scanned by the mangled_storage_impl directly in get_storage(), so they are demangled on load.
+    static constexpr bool lazy_demangling = false;
+#else
+    ///Itanium mangled names are stored in symbol_table::symbols and demangled on first lookup.
+    static constexpr bool lazy_demangling = true;
+#endif
+
+    static std::size_t hash_name(boost::string_view name)
+    {
+        // FNV-1a
+        boost::uint64_t hash = 14695981039346656037ull;
+        for (auto c : name)
+        {
+            hash ^= static_cast<unsigned char>(c);
+            hash *= 1099511628211ull;
+        }
+        return static_cast<std::size_t>(hash ^ (hash >> 32));
+    }
+
+    ///symbols of a class, holds indexes into symbol_table::symbols.
+    struct class_symbols
+    {
+        std::vector<boost::uint32_t> constructors;
+        std::vector<boost::uint32_t> destructors;
+        ///member functions and static variables by the unqualified name.
+        std::multimap<boost::string_view, boost::uint32_t> members;
+        ///index plus one, zero if there is no such symbol.
+        boost::uint32_t vtable = 0;
+        boost::uint32_t typeinfo = 0;
+    };
+    ///class_symbols by the qualified class name.
+    typedef std::map<std::string, class_symbols> class_index;
+
+    ///indexes of the symbols with the demangled names containing the trigram, in ascending order, by the trigram.
+    typedef std::unordered_map<boost::uint32_t, std::vector<boost::uint32_t> > trigram_index;
+
+    static boost::uint32_t trigram(const char * p)
+    {
+        return static_cast<boost::uint32_t>(static_cast<unsigned char>(p[0]))
+            | (static_cast<boost::uint32_t>(static_cast<unsigned char>(p[1])) << 8)
+            | (static_cast<boost::uint32_t>(static_cast<unsigned char>(p[2])) << 16);
+    }
+
+    ///Symbols of a library. Shared between the copies of the storage and between the storages of the libraries with
+    ///the same build-id, so it is modified only if not shared or under the mutex for demangling.
+    struct symbol_table
+    {
+        ///the source of symbols if symbols is empty, for example after get_storage() call or for MSVC.
+        ///Otherwise empty or a copy of symbols made by get_storage() const.
+        std::vector<entry> storage;
+        ///symbols with the names stored in arena.
+        std::vector<symbol> symbols;
+        string_arena arena;
+        ///open addressing hash table over the demangled names, holds indexes into symbols plus one, zero for empty slots.
+        std::vector<boost::uint32_t> index;
+        ///indexes into symbols sorted by the mangled names. Used for lookups while not all the symbols are demangled
+        ///and for lookups by the mangled name.
+        std::vector<boost::uint32_t> sorted;
+        ///true if all the symbols are demangled.
+        std::atomic<bool> demangled{true};
+        ///guards the demangling of symbols.
+        std::mutex mutex;
+        ///true if other storages could get this table by the build-id.
+        bool cached = false;
+        ///true if the entries of storage were given out for modification, lookups are not memoized then.
+        bool writable = false;
+        ///symbols grouped by the classes, built from the mangled names on first use under the mutex. Null if not built yet.
+        std::shared_ptr<const class_index> classes;
+        ///trigrams of the demangled names, built on first substring search under the mutex. Null if not built yet.
+        std::shared_ptr<const trigram_index> trigrams;
+
+        std::size_t size() const
+        {
+            return symbols.empty() ? storage.size() : symbols.size();
+        }
+
+        std::shared_ptr<symbol_table> clone()
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+
+            auto copy = std::make_shared<symbol_table>();
+            copy->symbols.reserve(symbols.size());
+            for (auto & s : symbols)
+            {
+                symbol c;
+                c.mangled = copy->arena.append(s.mangled);
+                if (s.demangled.data() == s.mangled.data())
+                    c.demangled = c.mangled;
+                else if (!s.demangled.empty())
+                    c.demangled = copy->arena.append(s.demangled);
+                copy->symbols.push_back(c);
+            }
+
+            copy->storage = storage;
+            copy->writable = writable;
+            copy->index   = index;
+            copy->sorted  = sorted;
+            copy->classes = classes;
+            copy->trigrams = trigrams;
+            copy->demangled.store(demangled.load(std::memory_order_relaxed), std::memory_order_relaxed);
+            return copy;
+        }
+
+        void build_index()
+        {
+            std::size_t size = 16;
+            while (size < symbols.size() * 2)
+                size *= 2;
+
+            index.assign(size, 0);
+            for (std::size_t i = 0; i < symbols.size(); ++i)
+            {
+                std::size_t slot = hash_name(symbols[i].demangled) & (size - 1);
+                while (index[slot])
+                    slot = (slot + 1) & (size - 1);
+                index[slot] = static_cast<boost::uint32_t>(i + 1);
+            }
+        }
+
+        static void demangle(symbol & s, string_arena & arena)
+        {
+            if (s.mangled.empty() || s.mangled[0] != '_')
+            {
+                s.demangled = s.mangled;
+                return;
+            }
+
+            const std::string dm = demangle_symbol(s.mangled.data()); // names in the arena are null terminated
+            s.demangled = (dm.empty() || dm == s.mangled) ? s.mangled : arena.append(dm);
+        }
+
+        ///demangles the symbols that are not demangled yet, using up to workers threads.
+        ///Each thread fills its own contiguous range of symbols, so the result does not depend on the workers count.
+        void demangle_symbols(std::size_t workers)
+        {
+            const std::size_t min_chunk = 256; // starting a thread costs about as much as demangling that many symbols
+            const std::size_t count = symbols.size();
+            workers = (std::min)(workers, count / min_chunk);
+
+            auto demangle_range = [this](std::size_t b, std::size_t e, string_arena & arena)
+            {
+                for (; b != e; ++b)
+                    if (symbols[b].demangled.empty())
+                        demangle(symbols[b], arena);
+            };
+
+            if (workers <= 1)
+            {
+                demangle_range(0, count, arena);
+                return;
+            }
+
+            const std::size_t chunk = (count + workers - 1) / workers;
+            std::vector<std::exception_ptr> errors(workers);
+            std::vector<string_arena> arenas(workers);
+            std::vector<std::thread> threads;
+            threads.reserve(workers - 1);
+
+            // The calling thread demangles the first chunk and the chunks of the threads that failed to start
+            std::size_t rest_begin = count;
+            for (std::size_t i = 1; i < workers; ++i)
+            {
+                const std::size_t b = (std::min)(count, i * chunk);
+                const std::size_t e = (std::min)(count, (i + 1) * chunk);
+                std::exception_ptr & error = errors[i];
+                string_arena & worker_arena = arenas[i];
+                try
+                {
+                    threads.emplace_back([b, e, &error, &worker_arena, &demangle_range]()
+                    {
+                        try
+                        {
+                            demangle_range(b, e, worker_arena);
+                        }
+                        catch (...)
+                        {
+                            error = std::current_exception();
+                        }
+                    });
+                }
+                catch (...)
+                {
+                    rest_begin = b;
+                    break;
+                }
+            }
+
+            try
+            {
+                demangle_range(0, (std::min)(count, chunk), arenas[0]);
+                demangle_range(rest_begin, count, arenas[0]);
+            }
+            catch (...)
+            {
+                errors[0] = std::current_exception();
+            }
+
+            for (auto & t : threads)
+                t.join();
+
+            try
+            {
+                for (auto & a : arenas)
+                    arena.splice(a);
+            }
+            catch (...)
+            {
+                // Names in the arenas that were not spliced are freed
+                for (auto & s : symbols)
+                    s.demangled = boost::string_view();
+                throw;
+            }
+
+            for (auto & error : errors)
+                if (error)
+                    std::rethrow_exception(error);
+        }
+
+        symbol at(std::size_t i) const
+        {
+            if (!symbols.empty())
+                return symbols[i];
+            const symbol s = {storage[i].mangled, storage[i].demangled};
+            return s;
+        }
+
+        ///returns the trigrams of the demangled names, all the symbols must be demangled.
+        const trigram_index & trigrams_index()
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (!trigrams)
+            {
+                auto index = std::make_shared<trigram_index>();
+                const std::size_t count = size();
+                for (std::size_t i = 0; i < count; ++i)
+                {
+                    const auto id = static_cast<boost::uint32_t>(i);
+                    const boost::string_view name = at(i).demangled;
+                    for (std::size_t pos = 0; pos + 3 <= name.size(); ++pos)
+                    {
+                        auto & postings = (*index)[trigram(name.data() + pos)];
+                        if (postings.empty() || postings.back() != id)
+                            postings.push_back(id);
+                    }
+                }
+                trigrams = std::move(index);
+            }
+            return *trigrams;
+        }
+
+        ///Demangles all the symbols that were not looked up yet, using up to workers threads.
+        void demangle_all(std::size_t workers = 1)
+        {
+            if (demangled.load(std::memory_order_acquire))
+                return;
+
+            std::lock_guard<std::mutex> lock(mutex);
+            if (demangled.load(std::memory_order_relaxed))
+                return;
+
+            demangle_symbols(workers);
+            build_index();
+            demangled.store(true, std::memory_order_release);
+        }
+
+        ///moves the entries of storage into symbols, if storage is the source of symbols. Drops the copy otherwise.
+        void to_symbols()
+        {
+            if (symbols.empty())
+            {
+                symbols.reserve(storage.size());
+                for (auto & e : storage)
+                {
+                    symbol s;
+                    s.mangled = arena.append(e.mangled);
+                    if (e.demangled == e.mangled)
+                        s.demangled = s.mangled;
+                    else if (!e.demangled.empty())
+                        s.demangled = arena.append(e.demangled);
+                    symbols.push_back(s);
+                }
+            }
+
+            std::vector<entry>().swap(storage);
+        }
+
+        ///fills storage with the copies of symbols, if storage is not the source of symbols.
+        const std::vector<entry> & materialize()
+        {
+            demangle_all();
+
+            std::lock_guard<std::mutex> lock(mutex);
+            if (storage.empty() && !symbols.empty())
+            {
+                storage.reserve(symbols.size());
+                for (auto & s : symbols)
+                    storage.emplace_back(s.mangled.to_string(), s.demangled.to_string());
+            }
+            return storage;
+        }
+
+        ///makes storage the source of symbols.
+        std::vector<entry> & to_storage()
+        {
+            materialize();
+            writable = true;
+            symbols.clear();
+            arena.clear();
+            index.clear();
+            sorted.clear();
+            classes.reset();
+            trigrams.reset();
+            return storage;
+        }
+
+        void add_symbols(const std::vector<std::string> & names)
+        {
+            writable = false;
+            trigrams.reset();
+            if (!lazy_demangling)
+            {
+                storage.reserve(storage.size() + names.size());
+                for (auto & sym : names)
+                {
+                    auto dm = demangle_symbol(sym);
+                    if (!dm.empty())
+                        storage.emplace_back(sym, dm);
+                    else
+                        storage.emplace_back(sym, sym);
+                }
+                return;
+            }
+
+            to_symbols();
+            symbols.reserve(symbols.size() + names.size());
+            for (auto & sym : names)
+            {
+                symbol s;
+                s.mangled = arena.append(sym);
+                symbols.push_back(s);
+            }
+
+            sorted.resize(symbols.size());
+            for (std::size_t i = 0; i < sorted.size(); ++i)
+                sorted[i] = static_cast<boost::uint32_t>(i);
+            std::sort(sorted.begin(), sorted.end(), [this](boost::uint32_t l, boost::uint32_t r) {
+                return symbols[l].mangled < symbols[r].mangled;
+            });
+
+            index.clear();
+            classes.reset();
+            trigrams.reset();
+            demangled.store(symbols.empty());
+        }
+    };
+
+    typedef std::map<boost::typeindex::ctti_type_index, std::string> aliases_map;
+
+    ///symbols, null for an empty storage.
+    std::shared_ptr<symbol_table> table_;
+    ///if a unknown class is imported it can be overloaded by this type. Null if there are no aliases.
+    std::shared_ptr<const aliases_map> aliases_;
+
+    template<typename... T>
+    struct lookup_types {};
+
+    ///results of the lookups, keyed by the kind of the lookup, the looked up types and the name.
+    ///The type of a result is defined by the kind of the lookup.
+    struct lookup_memo
+    {
+        typedef std::tuple<char, boost::typeindex::ctti_type_index, std::string> key_type;
+
+        std::mutex mutex;
+        std::map<key_type, std::shared_ptr<const void> > results;
+    };
+    ///valid while the symbols and aliases stay the same, shared with the copies. Null only in a moved from storage.
+    std::shared_ptr<lookup_memo> memo_ = std::make_shared<lookup_memo>();
+
+    ///returns the memoized result of lookup(), calls it on first request for the (kind, T..., name).
+    ///Concurrent calls for the same key may call lookup() more than once, all of them get the same result.
+    template<typename Result, typename... T, typename Func>
+    Result memoized(char kind, const std::string & name, Func lookup) const
+    {
+        if (!memo_ || (table_ && table_->writable))
+            return lookup();
+
+        lookup_memo & m = *memo_;
+        lookup_memo::key_type key(kind, boost::typeindex::ctti_type_index::type_id_with_cvr<lookup_types<T...> >(), name);
+        {
+            std::lock_guard<std::mutex> lock(m.mutex);
+            auto it = m.results.find(key);
+            if (it != m.results.end())
+                return *static_cast<const Result *>(it->second.get());
+        }
+
+        // Lookup is done without the lock, so that lookups of different names do not wait for each other
+        std::shared_ptr<const void> result = std::make_shared<const Result>(lookup());
+
+        std::lock_guard<std::mutex> lock(m.mutex);
+        return *static_cast<const Result *>(m.results.emplace(std::move(key), std::move(result)).first->second.get());
+    }
+
+    void reset_memo() { memo_ = std::make_shared<lookup_memo>(); }
+
+    ///returns the symbol table, that is not shared with other storages.
+    symbol_table & unique_table()
+    {
+        reset_memo();
+        if (!table_)
+            table_ = std::make_shared<symbol_table>();
+        else if (table_.use_count() > 1 || table_->cached)
+            table_ = table_->clone();
+        return *table_;
+    }
+
+    ///returns the symbol table for the library, shared with other storages of the same file with the same build-id.
+    ///A stripped copy keeps the build-id of the original, so the build-id alone does not identify the symbols.
+    static std::shared_ptr<symbol_table> shared_table(library_info & li)
+    {
+        typedef std::tuple<std::string, boost::dll::fs::path, boost::uintmax_t> key_type;
+        static std::mutex cache_mutex;
+        static std::map<key_type, std::weak_ptr<symbol_table> > cache;
+
+        std::string build_id = li.build_id();
+        boost::dll::fs::error_code ec;
+        boost::dll::fs::path path = boost::dll::fs::canonical(li.path_, ec);
+        const boost::uintmax_t size = ec ? 0 : static_cast<boost::uintmax_t>(boost::dll::fs::file_size(path, ec));
+        if (build_id.empty() || ec)
+        {
+            auto table = std::make_shared<symbol_table>();
+            table->add_symbols(li.symbols());
+            return table;
+        }
+
+        key_type key(std::move(build_id), std::move(path), size);
+        {
+            std::lock_guard<std::mutex> lock(cache_mutex);
+            auto it = cache.find(key);
+            if (it != cache.end())
+                if (auto table = it->second.lock())
+                    return table;
+        }
+
+        auto table = std::make_shared<symbol_table>();
+        table->add_symbols(li.symbols());
+        table->cached = true;
+
+        std::lock_guard<std::mutex> lock(cache_mutex);
+        for (auto it = cache.begin(); it != cache.end();)
+        {
+            if (it->second.expired())
+                it = cache.erase(it);
+            else
+                ++it;
+        }
+
+        auto & cached = cache[std::move(key)];
+        if (auto other = cached.lock())
+            return other; // loaded concurrently
+        cached = table;
+        return table;
+    }
+
+    static bool is_identifier_char(char c)
+    {
+        return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_';
+    }
+
+    ///skips the balanced brackets starting at pos, returns the position after the closing bracket or npos.
+    static std::size_t skip_brackets(const std::string & name, std::size_t pos, char open, char close)
+    {
+        std::size_t depth = 0;
+        for (; pos < name.size(); ++pos)
+        {
+            if (name[pos] == open)
+                ++depth;
+            else if (name[pos] == close && --depth == 0)
+                return pos + 1;
+        }
+        return std::string::npos;
+    }
+
+    ///Parses the Itanium mangled name of a class member: `_ZN [r] [V] [K] [R|O] <class> <member> E <args>`, `_ZTV <class>`
+    ///or `_ZTI <class>`. kind is 'c' for constructors, 'd' for destructors, 'm' for other members, 'v' for vtables and 't'
+    ///for typeinfos. Returns false for other names and for the names with substitutions, templates or ABI tags.
+    static bool parse_class_member(boost::string_view m, std::string & class_name, char & kind, boost::string_view & member)
+    {
+        std::vector<boost::string_view> ids;
+        // reads `<length> <identifier>`
+        auto source_name = [&m, &ids]() {
+            std::size_t len = 0;
+            std::size_t i = 0;
+            for (; i < m.size() && m[i] >= '0' && m[i] <= '9'; ++i)
+            {
+                len = len * 10 + static_cast<std::size_t>(m[i] - '0');
+                if (len > m.size())
+                    return false;
+            }
+            if (i == 0 || len == 0 || len > m.size() - i)
+                return false;
+            ids.push_back(m.substr(i, len));
+            m.remove_prefix(i + len);
+            return true;
+        };
+
+        member.clear();
+        std::size_t class_ids = 0;
+        if (m.starts_with("_ZTV") || m.starts_with("_ZTI"))
+        {
+            kind = (m[3] == 'V') ? 'v' : 't';
+            m.remove_prefix(4);
+            if (m.starts_with('N'))
+            {
+                m.remove_prefix(1);
+                while (!m.empty() && m.front() != 'E')
+                    if (!source_name())
+                        return false;
+                if (m.size() != 1 || ids.empty())
+                    return false;
+            }
+            else if (!source_name() || !m.empty())
+                return false;
+            class_ids = ids.size();
+        }
+        else if (m.starts_with("_ZN"))
+        {
+            m.remove_prefix(3);
+            while (!m.empty() && (m.front() == 'r' || m.front() == 'V' || m.front() == 'K'))
+                m.remove_prefix(1);
+            if (!m.empty() && (m.front() == 'R' || m.front() == 'O'))
+                m.remove_prefix(1);
+
+            while (!m.empty() && m.front() >= '0' && m.front() <= '9')
+                if (!source_name())
+                    return false;
+
+            if (m.size() >= 3 && (m[0] == 'C' || m[0] == 'D') && m[1] >= '0' && m[1] <= '3' && m[2] == 'E')
+            {
+                kind = (m[0] == 'C') ? 'c' : 'd';
+                class_ids = ids.size();
+            }
+            else if (!m.empty() && m[0] == 'E' && ids.size() > 1)
+            {
+                kind = 'm';
+                member = ids.back();
+                class_ids = ids.size() - 1;
+            }
+            else
+                return false;
+        }
+        else
+            return false;
+
+        class_name.clear();
+        for (std::size_t i = 0; i < class_ids; ++i)
+        {
+            if (i)
+                class_name += "::";
+            class_name.append(ids[i].data(), ids[i].size());
+        }
+        return !class_name.empty();
+    }
+
+    ///calls f for each symbol of the class class_name of the kind, see parse_class_member. For the 'm' kind only the symbols
+    ///of the members named member are visited. Does nothing if the symbols are not in the arena, for example for MSVC.
+    template<typename Func>
+    void for_each_class_symbol(const std::string & class_name, char kind, boost::string_view member, Func f) const
+    {
+        if (!table_ || table_->symbols.empty())
+            return;
+
+        symbol_table & t = *table_;
+        std::lock_guard<std::mutex> lock(t.mutex);
+        if (!t.classes)
+        {
+            auto classes = std::make_shared<class_index>();
+            std::string name;
+            for (std::size_t i = 0; i < t.symbols.size(); ++i)
+            {
+                char k;
+                boost::string_view m;
+                if (!parse_class_member(t.symbols[i].mangled, name, k, m))
+                    continue;
+
+                class_symbols & c = (*classes)[name];
+                const auto idx = static_cast<boost::uint32_t>(i);
+                switch (k)
+                {
+                case 'c': c.constructors.push_back(idx); break;
+                case 'd': c.destructors.push_back(idx); break;
+                case 'm': c.members.emplace(m, idx); break;
+                case 'v': c.vtable = idx + 1; break;
+                case 't': c.typeinfo = idx + 1; break;
+                }
+            }
+            t.classes = std::move(classes);
+        }
+
+        auto it = t.classes->find(class_name);
+        if (it == t.classes->end())
+            return;
+
+        auto visit = [&t, &f](boost::uint32_t i) {
+            symbol & s = t.symbols[i];
+            if (s.demangled.empty())
+                symbol_table::demangle(s, t.arena);
+            f(static_cast<const symbol &>(s));
+        };
+
+        const class_symbols & c = it->second;
+        switch (kind)
+        {
+        case 'c': for (auto i : c.constructors) visit(i); break;
+        case 'd': for (auto i : c.destructors) visit(i); break;
+        case 'm':
+            for (auto r = c.members.equal_range(member); r.first != r.second; ++r.first)
+                visit(r.first->second);
+            break;
+        case 'v': if (c.vtable) visit(c.vtable - 1); break;
+        case 't': if (c.typeinfo) visit(c.typeinfo - 1); break;
+        }
+    }
+
+    ///Fills out with the Itanium mangled name prefixes, that the symbols with the demangled name equal to name must have.
+    ///Returns false if name is not a plain `scope::function(args) qualifiers`, `scope::variable` or `typeinfo for scope::type`.
+    static bool itanium_prefixes(const std::string & name, std::vector<std::string> & out)
+    {
+        static const std::string typeinfo_for = "typeinfo for ";
+        const bool typeinfo = !name.compare(0, typeinfo_for.size(), typeinfo_for);
+
+        // Encoded scope, `<len>Name` for each of the leading identifiers followed by "::"
+        std::string scope;
+        std::size_t pos = typeinfo ? typeinfo_for.size() : 0;
+        std::size_t last = pos;
+        for (;;)
+        {
+            last = pos;
+            while (pos < name.size() && is_identifier_char(name[pos]))
+                ++pos;
+
+            if (pos == last || name.compare(pos, 2, "::"))
+                break;
+
+            // `std::` and the abbreviations are encoded as substitutions
+            if (scope.empty() && !name.compare(last, pos - last, "std"))
+                return false;
+
+            scope += std::to_string(pos - last);
+            scope.append(name, last, pos - last);
+            pos += 2;
+        }
+
+        if (typeinfo)
+        {
+            if (pos == last || pos != name.size())
+                return false;
+
+            const std::string id = name.substr(last);
+            if (scope.empty())
+            {
+                // builtin types are encoded with a single letter
+                static const char* const builtins[] = {
+                    "void", "bool", "char", "wchar_t", "char8_t", "char16_t", "char32_t",
+                    "short", "int", "long", "float", "double", "__int128", "__float128"
+                };
+                for (auto b : builtins)
+                    if (id == b)
+                        return false;
+
+                out.push_back("_ZTI" + std::to_string(id.size()) + id);
+            }
+            else
+            {
+                out.push_back("_ZTIN" + scope + std::to_string(id.size()) + id + 'E');
+            }
+            return true;
+        }
+
+        // Last component: `name`, `~name` or `name<args>` followed by nothing or by `(args) qualifiers`
+        if (pos == last)
+        {
+            if (scope.empty() || pos == name.size() || name[pos] != '~')
+                return false;
+            ++pos;
+            while (pos < name.size() && is_identifier_char(name[pos]))
+                ++pos;
+        }
+        else if (!name.compare(last, pos - last, "operator"))
+            return false;
+
+        if (pos < name.size() && name[pos] == '<')
+            pos = skip_brackets(name, pos, '<', '>');
+
+        if (pos < name.size())
+        {
+            if (pos == std::string::npos || name[pos] != '(')
+                return false;
+
+            pos = skip_brackets(name, pos, '(', ')');
+            if (pos == std::string::npos || name.find_first_of(":(", pos) != std::string::npos)
+                return false;
+        }
+
+        if (scope.empty())
+        {
+            const std::string id = name.substr(last, name.find_first_of("<(", last) - last);
+            out.push_back(id); // not mangled
+            out.push_back("_Z" + std::to_string(id.size()) + id);
+            out.push_back("_ZL" + std::to_string(id.size()) + id);
+            return true;
+        }
+
+        // The unqualified name ends the prefix, so only the symbols with that name are demangled:
+        // `<len>name`, `C` for constructors and `D` for destructors. Constructors can not be told
+        // from functions named as their namespace, so both are looked for.
+        std::vector<std::string> unqualified;
+        if (name[last] == '~')
+        {
+            unqualified.push_back("D");
+        }
+        else
+        {
+            const std::string id = name.substr(last, name.find_first_of("<(", last) - last);
+            unqualified.push_back(std::to_string(id.size()) + id);
+            const std::string & u = unqualified.back();
+            if (scope.size() >= u.size() && !scope.compare(scope.size() - u.size(), std::string::npos, u))
+                unqualified.push_back("C");
+        }
+
+        static const char* const cv_qualifiers[] = {"", "r", "V", "K", "rV", "rK", "VK", "rVK"};
+        static const char* const ref_qualifiers[] = {"", "R", "O"};
+        for (auto cv : cv_qualifiers)
+            for (auto ref : ref_qualifiers)
+                for (auto & u : unqualified)
+                    out.push_back(std::string("_ZN") + cv + ref + scope + u);
+        return true;
+    }
+
+
+    ///calls f for each symbol, that could have the demangled name equal to name, demangling those symbols on demand.
+    ///Returns false if all the symbols are already demangled or if name could not be mapped to the mangled name prefixes.
+    ///In the latter case all the symbols are demangled.
+    template<typename Func>
+    bool for_each_lazy_candidate(const std::string & name, Func f) const
+    {
+        if (!table_ || table_->demangled.load(std::memory_order_acquire))
+            return false;
+
+        std::vector<std::string> prefixes;
+        if (!itanium_prefixes(name, prefixes))
+        {
+            table_->demangle_all();
+            return false;
+        }
+
+        symbol_table & t = *table_;
+        std::lock_guard<std::mutex> lock(t.mutex);
+        if (t.demangled.load(std::memory_order_relaxed))
+            return false;
+
+        for (auto & prefix : prefixes)
+        {
+            auto it = std::lower_bound(t.sorted.begin(), t.sorted.end(), boost::string_view(prefix),
+                [&t](boost::uint32_t i, boost::string_view p) {
+                    return t.symbols[i].mangled < p;
+                });
+
+            for (; it != t.sorted.end() && t.symbols[*it].mangled.starts_with(prefix); ++it)
+            {
+                symbol & s = t.symbols[*it];
+                if (s.demangled.empty())
+                    symbol_table::demangle(s, t.arena);
+                f(static_cast<const symbol &>(s));
+            }
+        }
+        return true;
+    }
+
+    ///calls f for each symbol, demangling all of them.
+    template<typename Func>
+    void for_each_symbol(Func f) const
+    {
+        if (!table_)
+            return;
+
+        table_->demangle_all();
+        if (table_->symbols.empty())
+        {
+            for (auto & e : table_->storage)
+            {
+                const symbol s = {e.mangled, e.demangled};
+                f(s);
+            }
+            return;
+        }
+
+        for (auto & s : table_->symbols)
+            f(static_cast<const symbol &>(s));
+    }
+
+    ///calls f for each symbol that could have the demangled name equal to name or a name ending with name.
+    template<typename Func>
+    void for_each_candidate(const std::string & name, Func f) const
+    {
+        if (!for_each_lazy_candidate(name, f))
+            for_each_symbol(f);
+    }
+
+    ///calls f for each symbol with the demangled name equal to name.
+    template<typename Func>
+    void for_each_demangled(const std::string & name, Func f) const
+    {
+        auto filter = [&name, &f](const symbol & s) {
+            if (s.demangled == name)
+                f(s);
+        };
+        if (for_each_lazy_candidate(name, filter))
+            return;
+
+        if (!table_ || table_->index.empty())
+        {
+            for_each_symbol(filter);
+            return;
+        }
+
+        const symbol_table & t = *table_;
+        const std::size_t mask = t.index.size() - 1;
+        for (std::size_t slot = hash_name(name) & mask; t.index[slot]; slot = (slot + 1) & mask)
+        {
+            const symbol & s = t.symbols[t.index[slot] - 1];
+            if (s.demangled == name)
+                f(s);
+        }
+    }
+
+    ///calls f for each symbol with the demangled name containing name, in the order of the symbols. Demangles all the symbols.
+    ///Only the symbols containing the rarest trigram of name are compared, so the cost depends on the number of the found symbols.
+    template<typename Func>
+    void for_each_containing(const std::string & name, Func f) const
+    {
+        auto filter = [&name, &f](const symbol & s) {
+            if (s.demangled.find(name) != boost::string_view::npos)
+                f(s);
+        };
+        if (!table_ || name.size() < 3 || table_->writable)
+        {
+            for_each_symbol(filter);
+            return;
+        }
+
+        symbol_table & t = *table_;
+        t.demangle_all();
+        const trigram_index & index = t.trigrams_index();
+
+        const std::vector<boost::uint32_t> * rarest = nullptr;
+        for (std::size_t pos = 0; pos + 3 <= name.size(); ++pos)
+        {
+            auto it = index.find(trigram(name.data() + pos));
+            if (it == index.end())
+                return;
+            if (!rarest || it->second.size() < rarest->size())
+                rarest = &it->second;
+        }
+
+        for (auto i : *rarest)
+            filter(t.at(i));
+    }
+
+    ///returns true if there is a symbol with the mangled name equal to mangled. Binary search in the mangled
+    ///order, nothing is demangled: a mangled name identifies the entity and its signature exactly.
+    bool has_mangled(boost::string_view mangled) const
+    {
+        if (!table_)
+            return false;
+
+        const symbol_table & t = *table_;
+        if (t.symbols.empty())
+        {
+            for (auto & e : t.storage)
+                if (e.mangled == mangled)
+                    return true;
+            return false;
+        }
+
+        auto it = std::lower_bound(t.sorted.begin(), t.sorted.end(), mangled,
+            [&t](boost::uint32_t i, boost::string_view m) {
+                return t.symbols[i].mangled < m;
+            });
+        return it != t.sorted.end() && t.symbols[*it].mangled == mangled;
+    }
+
+    ///returns the mangled name of the first symbol with the demangled name equal to name or an empty string.
+    std::string find_mangled(const std::string & name) const
+    {
+        std::string found;
+        auto filter = [&name, &found](const symbol & s) {
+            if (found.empty() && s.demangled == name)
+                found = s.mangled.to_string();
+        };
+        if (for_each_lazy_candidate(name, filter))
+            return found;
+
+        if (!table_ || table_->index.empty())
+        {
+            for_each_symbol(filter);
+            return found;
+        }
+
+        const symbol_table & t = *table_;
+        const std::size_t mask = t.index.size() - 1;
+        for (std::size_t slot = hash_name(name) & mask; t.index[slot]; slot = (slot + 1) & mask)
+        {
+            const symbol & s = t.symbols[t.index[slot] - 1];
+            if (s.demangled == name)
+                return s.mangled.to_string();
+        }
+        return found;
+    }
+public:
+    ///Returns true for the symbols to store, takes the mangled name. It is called before the symbol is demangled.
+    typedef std::function<bool(const std::string &)> symbol_filter;
+
+    /*! Returns a filter that accepts the members of the namespaces and classes in scopes, e.g. `{"some_space", "other_space::some_class"}`,
+     * with the members of the nested scopes and the vtables and typeinfos of the classes.
+     *
+     * With the Itanium ABI the scopes are matched against the mangled names. The `std` namespace is matched by its `St` abbreviation
+     * only, so the names with other abbreviations, like `std::string`, are not accepted. For MSVC the names are demangled to match them.
+     */
+    static symbol_filter scope_filter(const std::vector<std::string> & scopes)
+    {
+        std::vector<std::string> encoded;
+        for (auto & scope : scopes)
+        {
+            if (scope.empty())
+                continue;
+
+            std::string e;
+            std::size_t pos = 0;
+            while (pos <= scope.size())
+            {
+                std::size_t end = scope.find("::", pos);
+                if (end == std::string::npos)
+                    end = scope.size();
+                const std::string id = scope.substr(pos, end - pos);
+                if (lazy_demangling)
+                    e += (e.empty() && id == "std") ? std::string("St") : std::to_string(id.size()) + id;
+                pos = end + 2;
+            }
+            encoded.push_back(lazy_demangling ? e : scope + "::");
+        }
+
+        return [encoded](const std::string & mangled) {
+            if (!lazy_demangling)
+            {
+                const std::string demangled = demangle_symbol(mangled);
+                for (auto & e : encoded)
+                {
+                    for (auto pos = demangled.find(e); pos != std::string::npos; pos = demangled.find(e, pos + 1))
+                    {
+                        if (pos == 0 || !is_identifier_char(demangled[pos - 1]))
+                            return true;
+                    }
+                }
+                return false;
+            }
+
+            // `_ZN [r] [V] [K] [R|O] <scope>...`, `_ZSt...` and `_ZT{V,I,S} <scope>...`
+            boost::string_view m = mangled;
+            if (!m.starts_with("_Z"))
+                return false;
+            m.remove_prefix(2);
+            if (m.size() > 1 && m[0] == 'T' && (m[1] == 'V' || m[1] == 'I' || m[1] == 'S'))
+                m.remove_prefix(2);
+            if (m.starts_with('N'))
+            {
+                m.remove_prefix(1);
+                while (!m.empty() && (m.front() == 'r' || m.front() == 'V' || m.front() == 'K'))
+                    m.remove_prefix(1);
+                if (!m.empty() && (m.front() == 'R' || m.front() == 'O'))
+                    m.remove_prefix(1);
+            }
+            else if (!m.starts_with("St"))
+                return false;
+
+            for (auto & e : encoded)
+                if (m.starts_with(e))
+                    return true;
+            return false;
+        };
+    }
+
 public:
     void assign(const mangled_storage_base & storage)
     {
-        aliases_  = storage.aliases_;
-        storage_  = storage.storage_;
+        table_   = storage.table_;
+        aliases_ = storage.aliases_;
+        memo_    = storage.memo_;
     }
     void swap( mangled_storage_base & storage)
     {
+        table_.swap(storage.table_);
         aliases_.swap(storage.aliases_);
-        storage_.swap(storage.storage_);
+        memo_.swap(storage.memo_);
     }
     void clear()
     {
-        storage_.clear();
-        aliases_.clear();
+        table_.reset();
+        aliases_.reset();
+        reset_memo();
+    }
+    ///Demangles all the symbols that were not looked up yet, using up to workers threads. Lookups do not lock after this call.
+    void demangle_all(std::size_t workers = 1) const
+    {
+        if (table_)
+            table_->demangle_all(workers);
     }
-    std::vector<entry> & get_storage() {return storage_;};
+    ///Read-only random access range over the symbols, returned by get_symbols(). Elements are the symbols
+    ///with the names pointing into the storage. Keeps the symbols alive, modifications of the storage
+    ///do not change the symbols of a view that was taken before them.
+    class storage_view
+    {
+        std::shared_ptr<const symbol_table> table_;
+
+    public:
+        class iterator: public boost::iterator_facade<iterator, const symbol, boost::random_access_traversal_tag, symbol>
+        {
+            friend class boost::iterator_core_access;
+
+            const symbol_table * table_ = nullptr;
+            std::size_t pos_ = 0;
+
+            symbol dereference() const { return table_->at(pos_); }
+            bool equal(const iterator & other) const { return table_ == other.table_ && pos_ == other.pos_; }
+            void increment() { ++pos_; }
+            void decrement() { --pos_; }
+            void advance(std::ptrdiff_t n) { pos_ += n; }
+            std::ptrdiff_t distance_to(const iterator & other) const
+            {
+                return static_cast<std::ptrdiff_t>(other.pos_) - static_cast<std::ptrdiff_t>(pos_);
+            }
+
+        public:
+            iterator() = default;
+            iterator(const symbol_table * table, std::size_t pos) : table_(table), pos_(pos) {}
+        };
+        typedef iterator const_iterator;
+
+        storage_view() = default;
+        explicit storage_view(std::shared_ptr<const symbol_table> table) : table_(std::move(table)) {}
+
+        std::size_t size() const {return table_ ? table_->size() : 0;}
+        bool empty() const {return !size();}
+        iterator begin() const {return iterator(table_.get(), 0);}
+        iterator end() const {return iterator(table_.get(), size());}
+        symbol operator[](std::size_t i) const {return table_->at(i);}
+    };
+
+    ///Demangles all the symbols on first call, does not copy the names unlike get_storage().
+    storage_view get_symbols() const
+    {
+        if (!table_)
+            return storage_view();
+        table_->demangle_all();
+        return storage_view(table_);
+    };
+    ///Lookups fall back to linear search after this call, because the entries could be modified. Call add_symbols or load to build the index again.
+    ///Symbols are not shared with other storages after this call.
+    std::vector<entry> & get_storage() {return unique_table().to_storage();};
+    ///Creates the entries with the names copied from the arena on first call, so the memory usage grows.
+    ///Use get_symbols() to read the symbols without the copies.
+    const std::vector<entry> & get_storage() const
+    {
+        static const std::vector<entry> empty;
+        return table_ ? table_->materialize() : empty;
+    };
     template<typename T>
     std::string get_name() const
     {
         using boost::typeindex::ctti_type_index;
         auto tx = ctti_type_index::type_id<T>();
-        auto val = (aliases_.count(tx) > 0) ? aliases_.at(tx) : tx.pretty_name();
-        return val;
+        if (aliases_)
+        {
+            auto it = aliases_->find(tx);
+            if (it != aliases_->end())
+                return it->second;
+        }
+        return tx.pretty_name();
     }
 
     mangled_storage_base() = default;
     mangled_storage_base(mangled_storage_base&&) = default;
+    ///Shares the symbols and aliases with storage, costs a refcount increment for each.
     mangled_storage_base(const mangled_storage_base&) = default;
 
     mangled_storage_base(const std::vector<std::string> & symbols) { add_symbols(symbols);}
 
-    explicit mangled_storage_base(library_info & li) : mangled_storage_base(li.symbols()) {}
+    explicit mangled_storage_base(library_info & li) { load(li); }
 
     explicit mangled_storage_base(
             const boost::dll::fs::path& library_path,
             bool throw_if_not_native_format = true)
-        : mangled_storage_base(library_info(library_path, throw_if_not_native_format).symbols())
     {
-
+        load(library_path, throw_if_not_native_format);
     }
 
-    void load(library_info & li) { storage_.clear(); add_symbols(li.symbols()); };
+    ///Shares the symbols with other storages of the same file with the same build-id.
+    void load(library_info & li) { table_ = shared_table(li); reset_memo(); };
+    ///Stores only the symbols accepted by filter, an empty filter accepts all the symbols.
+    ///The filtered symbols are not shared with other storages.
+    void load(library_info & li, const symbol_filter & filter)
+    {
+        if (!filter)
+        {
+            load(li);
+            return;
+        }
+
+        std::vector<std::string> names = li.symbols();
+        names.erase(
+            std::remove_if(names.begin(), names.end(), [&filter](const std::string & name) { return !filter(name); }),
+            names.end()
+        );
+
+        auto table = std::make_shared<symbol_table>();
+        table->add_symbols(names);
+        table_ = std::move(table);
+        reset_memo();
+    }
+    //! \overload void load(library_info & li)
     void load(const boost::dll::fs::path& library_path,
             bool throw_if_not_native_format = true)
     {
-        storage_.clear();
-        add_symbols(library_info(library_path, throw_if_not_native_format).symbols());
+        load(library_path, throw_if_not_native_format, symbol_filter());
+    };
+    //! \overload void load(library_info & li, const symbol_filter & filter)
+    void load(const boost::dll::fs::path& library_path,
+            bool throw_if_not_native_format,
+            const symbol_filter & filter)
+    {
+#ifdef BOOST_DLL_ENABLE_TRACING
+        const boost::dll::detail::storage_trace trace(library_path);
+#endif
+        library_info li(library_path, throw_if_not_native_format);
+        load(li, filter);
+#ifdef BOOST_DLL_ENABLE_TRACING
+        trace.finish(table_->size());
+#endif
     };
 
     /*! Allows do add a class as alias, if the class imported is not known
@@ -94,23 +1215,27 @@ public:
      */
     template<typename Alias> void add_alias(const std::string& name)
     {
-        aliases_.emplace(
+        auto aliases = aliases_ ? std::make_shared<aliases_map>(*aliases_) : std::make_shared<aliases_map>();
+        aliases->emplace(
             boost::typeindex::ctti_type_index::type_id<Alias>(),
             name
             );
+        aliases_ = std::move(aliases);
+        reset_memo();
     }
     void add_symbols(const std::vector<std::string> & symbols)
     {
-        for (auto & sym : symbols)
-        {
-            auto dm = demangle_symbol(sym);
-            if (!dm.empty())
-                storage_.emplace_back(sym, dm);
-            else
-                storage_.emplace_back(sym, sym);
-        }
+        unique_table().add_symbols(symbols);
     }
 
+    ///Adds the symbols and demangles all the symbols using up to workers threads, for example std::thread::hardware_concurrency().
+    ///Symbols are stored in the order of the input, as with the single threaded add_symbols.
+    void add_symbols(const std::vector<std::string> & symbols, std::size_t workers)
+    {
+        symbol_table & t = unique_table();
+        t.add_symbols(symbols);
+        t.demangle_all(workers);
+    }
 
 };
 
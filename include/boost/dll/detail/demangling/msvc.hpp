@@ -45,20 +45,36 @@ public:
 
     using mangled_storage_base::mangled_storage_base;
 
+    // Lookups are memoized, repeated calls with the same arguments do not search the symbols again.
     template<typename T>
-    std::string get_variable(const std::string &name) const;
+    std::string get_variable(const std::string &name) const
+    {
+        return memoized<std::string, T>('v', name, [&]{ return find_variable<T>(name); });
+    }
 
     template<typename Func>
-    std::string get_function(const std::string &name) const;
+    std::string get_function(const std::string &name) const
+    {
+        return memoized<std::string, Func>('f', name, [&]{ return find_function<Func>(name); });
+    }
 
     template<typename Class, typename Func>
-    std::string get_mem_fn(const std::string &name) const;
+    std::string get_mem_fn(const std::string &name) const
+    {
+        return memoized<std::string, Class, Func>('m', name, [&]{ return find_mem_fn<Class, Func>(name); });
+    }
 
     template<typename Signature>
-    ctor_sym get_constructor() const;
+    ctor_sym get_constructor() const
+    {
+        return memoized<ctor_sym, Signature>('c', std::string(), [&]{ return find_constructor<Signature>(); });
+    }
 
     template<typename Class>
-    dtor_sym get_destructor() const;
+    dtor_sym get_destructor() const
+    {
+        return memoized<dtor_sym, Class>('d', std::string(), [&]{ return find_destructor<Class>(); });
+    }
 
     template<typename T> //overload, does not need to virtual.
     std::string get_name() const
@@ -69,11 +85,32 @@ public:
     }
 
     template<typename T>
-    std::string get_vtable() const;
+    std::string get_vtable() const
+    {
+        return memoized<std::string, T>('t', std::string(), [&]{ return find_vtable<T>(); });
+    }
 
     template<typename T>
     std::vector<std::string> get_related() const;
 
+private:
+    template<typename T>
+    std::string find_variable(const std::string &name) const;
+
+    template<typename Func>
+    std::string find_function(const std::string &name) const;
+
+    template<typename Class, typename Func>
+    std::string find_mem_fn(const std::string &name) const;
+
+    template<typename Signature>
+    auto find_constructor() const -> ctor_sym;
+
+    template<typename Class>
+    auto find_destructor() const -> dtor_sym;
+
+    template<typename T>
+    std::string find_vtable() const;
 };
 
 void mangled_storage_impl::trim_typename(std::string & val)
@@ -194,7 +231,7 @@ namespace parser
 }
 
 
-template<typename T> std::string mangled_storage_impl::get_variable(const std::string &name) const
+template<typename T> std::string mangled_storage_impl::find_variable(const std::string &name) const
 {
     using namespace std;
     using namespace boost;
@@ -209,7 +246,7 @@ template<typename T> std::string mangled_storage_impl::get_variable(const std::s
             parser::type_rule<T>(type_name) >> x3::space >>
             name;
 
-    auto predicate = [&](const mangled_storage_base::entry & e)
+    auto predicate = [&](const mangled_storage_base::symbol & e)
         {
             if (e.demangled == name)//maybe not mangled,
                 return true;
@@ -220,15 +257,16 @@ template<typename T> std::string mangled_storage_impl::get_variable(const std::s
             return res && (itr == end);
         };
 
-    auto found = std::find_if(storage_.begin(), storage_.end(), predicate);
+    const auto storage = get_symbols();
+    auto found = std::find_if(storage.begin(), storage.end(), predicate);
 
-    if (found != storage_.end())
-        return found->mangled;
+    if (found != storage.end())
+        return found->mangled.to_string();
     else
         return "";
 }
 
-template<typename Func> std::string mangled_storage_impl::get_function(const std::string &name) const
+template<typename Func> std::string mangled_storage_impl::find_function(const std::string &name) const
 {
     namespace x3 = spirit::x3;
     using namespace parser;
@@ -244,7 +282,7 @@ template<typename Func> std::string mangled_storage_impl::get_function(const std
                 name >> x3::lit('(') >> parser::arg_list(*this, func_type()) >> x3::lit(')') >>  parser::ptr_rule();
 
 
-    auto predicate = [&](const mangled_storage_base::entry & e)
+    auto predicate = [&](const mangled_storage_base::symbol & e)
             {
                 if (e.demangled == name)//maybe not mangled,
                     return true;
@@ -256,17 +294,18 @@ template<typename Func> std::string mangled_storage_impl::get_function(const std
                 return res && (itr == end);
             };
 
-    auto found = std::find_if(storage_.begin(), storage_.end(), predicate);
+    const auto storage = get_symbols();
+    auto found = std::find_if(storage.begin(), storage.end(), predicate);
 
-    if (found != storage_.end())
-        return found->mangled;
+    if (found != storage.end())
+        return found->mangled.to_string();
     else
         return "";
 
 }
 
 template<typename Class, typename Func>
-std::string mangled_storage_impl::get_mem_fn(const std::string &name) const
+std::string mangled_storage_impl::find_mem_fn(const std::string &name) const
 {
     namespace x3 = spirit::x3;
     using namespace parser;
@@ -285,7 +324,7 @@ std::string mangled_storage_impl::get_mem_fn(const std::string &name) const
                 x3::lit('(') >> parser::arg_list(*this, func_type()) >> x3::lit(')') >>
                 inv_const_rule<Class>() >> inv_volatile_rule<Class>() >> parser::ptr_rule();
 
-    auto predicate = [&](const mangled_storage_base::entry & e)
+    auto predicate = [&](const mangled_storage_base::symbol & e)
             {
                 auto itr = e.demangled.begin();
                 auto end = e.demangled.end();
@@ -294,17 +333,18 @@ std::string mangled_storage_impl::get_mem_fn(const std::string &name) const
                 return res && (itr == end);
             };
 
-    auto found = std::find_if(storage_.begin(), storage_.end(), predicate);
+    const auto storage = get_symbols();
+    auto found = std::find_if(storage.begin(), storage.end(), predicate);
 
-    if (found != storage_.end())
-        return found->mangled;
+    if (found != storage.end())
+        return found->mangled.to_string();
     else
         return "";
 }
 
 
 template<typename Signature>
-auto mangled_storage_impl::get_constructor() const -> ctor_sym
+auto mangled_storage_impl::find_constructor() const -> ctor_sym
 {
     namespace x3 = spirit::x3;
     using namespace parser;
@@ -336,7 +376,7 @@ auto mangled_storage_impl::get_constructor() const -> ctor_sym
                 x3::lit('(') >> parser::arg_list(*this, func_type()) >> x3::lit(')') >> parser::ptr_rule();
 
 
-    auto predicate = [&](const mangled_storage_base::entry & e)
+    auto predicate = [&](const mangled_storage_base::symbol & e)
             {
                 auto itr = e.demangled.begin();
                 auto end = e.demangled.end();
@@ -345,16 +385,17 @@ auto mangled_storage_impl::get_constructor() const -> ctor_sym
                 return res && (itr == end);
             };
 
-    auto f = std::find_if(storage_.begin(), storage_.end(), predicate);
+    const auto storage = get_symbols();
+    auto f = std::find_if(storage.begin(), storage.end(), predicate);
 
-    if (f != storage_.end())
-        return f->mangled;
+    if (f != storage.end())
+        return f->mangled.to_string();
     else
         return "";
 }
 
 template<typename Class>
-auto mangled_storage_impl::get_destructor() const -> dtor_sym
+auto mangled_storage_impl::find_destructor() const -> dtor_sym
 {
     namespace x3 = spirit::x3;
     using namespace parser;
@@ -381,7 +422,7 @@ auto mangled_storage_impl::get_destructor() const -> dtor_sym
                 dtor_name >> parser::ptr_rule();
 
 
-    auto predicate = [&](const mangled_storage_base::entry & e)
+    auto predicate = [&](const mangled_storage_base::symbol & e)
                 {
                     auto itr = e.demangled.begin();
                     auto end = e.demangled.end();
@@ -390,30 +431,32 @@ auto mangled_storage_impl::get_destructor() const -> dtor_sym
                     return res && (itr == end);
                 };
 
-    auto found = std::find_if(storage_.begin(), storage_.end(), predicate);
+    const auto storage = get_symbols();
+    auto found = std::find_if(storage.begin(), storage.end(), predicate);
 
 
-    if (found != storage_.end())
-        return found->mangled;
+    if (found != storage.end())
+        return found->mangled.to_string();
     else
         return "";
 }
 
 template<typename T>
-std::string mangled_storage_impl::get_vtable() const
+std::string mangled_storage_impl::find_vtable() const
 {
     std::string id = "const " + get_name<T>() + "::`vftable'";
 
-    auto predicate = [&](const mangled_storage_base::entry & e)
+    auto predicate = [&](const mangled_storage_base::symbol & e)
                 {
                     return e.demangled == id;
                 };
 
-    auto found = std::find_if(storage_.begin(), storage_.end(), predicate);
+    const auto storage = get_symbols();
+    auto found = std::find_if(storage.begin(), storage.end(), predicate);
 
 
-    if (found != storage_.end())
-        return found->mangled;
+    if (found != storage.end())
+        return found->mangled.to_string();
     else
         return "";
 }
@@ -424,11 +467,10 @@ std::vector<std::string> mangled_storage_impl::get_related() const
     std::vector<std::string> ret;
     auto name = get_name<T>();
 
-    for (auto & c : storage_)
+    for_each_containing(name, [&ret](const symbol& c)
     {
-        if (c.demangled.find(name) != std::string::npos)
-            ret.push_back(c.demangled);
-    }
+        ret.push_back(c.demangled.to_string());
+    });
 
     return ret;
 }
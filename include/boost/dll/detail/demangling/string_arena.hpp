@@ -0,0 +1,95 @@
+// Copyright 2020 Antony Polukhin.
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt
+// or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BOOST_DLL_DETAIL_DEMANGLING_STRING_ARENA_HPP_
+#define BOOST_DLL_DETAIL_DEMANGLING_STRING_ARENA_HPP_
+
+#include <boost/dll/config.hpp>
+#include <boost/utility/string_view.hpp>
+
+#include <cstring>
+#include <memory>
+#include <vector>
+
+#ifdef BOOST_HAS_PRAGMA_ONCE
+# pragma once
+#endif
+
+namespace boost { namespace dll { namespace detail {
+
+// Stores null terminated copies of strings in big chunks, that are never moved or freed until clear().
+// Appending does not invalidate the views to the already stored strings, moving or swapping the arena
+// does not invalidate them either.
+class string_arena {
+    static const std::size_t chunk_size = 64 * 1024;
+
+    std::vector<std::unique_ptr<char[]> > chunks_;
+    char* free_ = nullptr;
+    std::size_t left_ = 0;
+
+public:
+    string_arena() = default;
+    string_arena(const string_arena&) = delete;
+    string_arena& operator=(const string_arena&) = delete;
+
+    string_arena(string_arena&& other) noexcept {
+        swap(other);
+    }
+
+    string_arena& operator=(string_arena&& other) noexcept {
+        string_arena tmp(std::move(other));
+        swap(tmp);
+        return *this;
+    }
+
+    boost::string_view append(boost::string_view s) {
+        const std::size_t size = s.size() + 1;
+        char* dest;
+        if (size > chunk_size / 8) {
+            // Big strings get their own chunk, to not waste the rest of the current one
+            chunks_.emplace_back(new char[size]);
+            dest = chunks_.back().get();
+        } else {
+            if (size > left_) {
+                chunks_.emplace_back(new char[chunk_size]);
+                free_ = chunks_.back().get();
+                left_ = chunk_size;
+            }
+            dest = free_;
+            free_ += size;
+            left_ -= size;
+        }
+
+        std::memcpy(dest, s.data(), s.size());
+        dest[s.size()] = '\0';
+        return boost::string_view(dest, s.size());
+    }
+
+    // Takes the chunks of `other`, views to the strings of `other` stay valid.
+    void splice(string_arena& other) {
+        chunks_.reserve(chunks_.size() + other.chunks_.size());
+        for (auto& chunk : other.chunks_) {
+            chunks_.push_back(std::move(chunk));
+        }
+        other.clear();
+    }
+
+    void swap(string_arena& other) noexcept {
+        chunks_.swap(other.chunks_);
+        std::swap(free_, other.free_);
+        std::swap(left_, other.left_);
+    }
+
+    void clear() noexcept {
+        chunks_.clear();
+        free_ = nullptr;
+        left_ = 0;
+    }
+};
+
+}}} // namespace boost::dll::detail
+
+#endif // BOOST_DLL_DETAIL_DEMANGLING_STRING_ARENA_HPP_
@@ -16,6 +16,8 @@
 
 #include <cstring>
 #include <fstream>
+#include <string>
+#include <vector>
 
 #include <boost/cstdint.hpp>
 
@@ -90,6 +92,14 @@ struct Elf_Sym_template<boost::uint64_t> {
 typedef Elf_Sym_template<boost::uint32_t> Elf32_Sym_;
 typedef Elf_Sym_template<boost::uint64_t> Elf64_Sym_;
 
+// Symbol with its address, as used by the boost::dll::symbolizer.
+struct elf_symbol_address {
+    boost::uint64_t value;  // Address relative to the load bias
+    boost::uint64_t size;
+    boost::uint32_t name;   // Offset of the null-terminated name in the names table
+    bool            global;
+};
+
 template <class AddressOffsetT>
 class elf_info {
     typedef boost::dll::detail::Elf_Ehdr_template<AddressOffsetT>  header_t;
@@ -98,6 +108,11 @@ class elf_info {
 
     BOOST_STATIC_CONSTANT(boost::uint32_t, SHT_SYMTAB_ = 2);
     BOOST_STATIC_CONSTANT(boost::uint32_t, SHT_STRTAB_ = 3);
+    BOOST_STATIC_CONSTANT(boost::uint32_t, SHT_NOBITS_ = 8);
+    BOOST_STATIC_CONSTANT(boost::uint32_t, SHT_DYNSYM_ = 11);
+
+    BOOST_STATIC_CONSTANT(unsigned char, STT_OBJECT_ = 1);  /* Symbol is a data object */
+    BOOST_STATIC_CONSTANT(unsigned char, STT_FUNC_ = 2);    /* Symbol is a code object */
 
     BOOST_STATIC_CONSTANT(unsigned char, STB_LOCAL_ = 0);   /* Local symbol */
     BOOST_STATIC_CONSTANT(unsigned char, STB_GLOBAL_ = 1);  /* Global symbol */
@@ -131,14 +146,20 @@ public:
         std::vector<std::string> ret;
         std::vector<char> names;
         sections_names_raw(fs, names);
-        
-        const char* name_begin = &names[0];
-        const char* const name_end = name_begin + names.size();
-        ret.reserve(header(fs).e_shnum);
-        do {
-            ret.push_back(name_begin);
-            name_begin += ret.back().size() + 1;
-        } while (name_begin != name_end);
+
+        // Names are taken by the offsets from the section headers, because the linker merges
+        // the names that are suffixes of other names (for example "boostdll" and ".note.boostdll").
+        const header_t elf = header(fs);
+        ret.reserve(elf.e_shnum);
+        for (std::size_t i = 0; i < elf.e_shnum; ++i) {
+            section_t section;
+            fs.seekg(elf.e_shoff + i * sizeof(section_t));
+            read_raw(fs, section);
+
+            if (section.sh_name < names.size() && names[section.sh_name]) {
+                ret.push_back(&names[0] + section.sh_name);
+            }
+        }
 
         return ret;
     }
@@ -223,6 +244,127 @@ public:
         return ret;
     }
 
+    // Reads all the defined functions and objects, including the non exported ones. Uses `.symtab`
+    // or `.dynsym` if the binary was stripped. Unlike symbols_text(), takes the names from the
+    // string table that is linked to the symbol table.
+    static void symbols_addresses(std::ifstream& fs, std::vector<boost::dll::detail::elf_symbol_address>& ret, std::vector<char>& names) {
+        ret.clear();
+        names.clear();
+
+        const header_t elf = header(fs);
+        std::vector<section_t> sections(elf.e_shnum);
+        if (sections.empty()) {
+            return;
+        }
+        fs.seekg(elf.e_shoff);
+        read_raw(fs, sections[0], sections.size() * sizeof(section_t));
+
+        std::size_t table = sections.size();
+        for (std::size_t i = 0; i < sections.size(); ++i) {
+            if (sections[i].sh_type == SHT_SYMTAB_) {
+                table = i;
+                break;
+            } else if (sections[i].sh_type == SHT_DYNSYM_) {
+                table = i;
+            }
+        }
+        if (table == sections.size() || sections[table].sh_link >= sections.size()) {
+            return;
+        }
+
+        const section_t& strings = sections[sections[table].sh_link];
+        names.resize(static_cast<std::size_t>(strings.sh_size) + 1);
+        fs.seekg(strings.sh_offset);
+        read_raw(fs, names[0], static_cast<std::size_t>(strings.sh_size));
+        names.back() = '\0';
+
+        std::vector<symbol_t> symbols(static_cast<std::size_t>(sections[table].sh_size / sizeof(symbol_t)));
+        if (symbols.empty()) {
+            return;
+        }
+        fs.seekg(sections[table].sh_offset);
+        read_raw(fs, symbols[0], symbols.size() * sizeof(symbol_t));
+
+        ret.reserve(symbols.size());
+        for (std::size_t i = 0; i < symbols.size(); ++i) {
+            const unsigned char type = symbols[i].st_info & 0x0f;
+            // Skipping undefined (0) and special (SHN_LORESERVE and above, e.g. absolute) symbols
+            if ((type != STT_FUNC_ && type != STT_OBJECT_) || !symbols[i].st_shndx || symbols[i].st_shndx >= 0xff00 || !symbols[i].st_value
+                || symbols[i].st_name >= names.size() || !names[symbols[i].st_name])
+            {
+                continue;
+            }
+
+            const boost::dll::detail::elf_symbol_address sym = {
+                symbols[i].st_value,
+                symbols[i].st_size,
+                symbols[i].st_name,
+                (symbols[i].st_info >> 4) != STB_LOCAL_
+            };
+            ret.push_back(sym);
+        }
+    }
+
+    // Reads the content of the section. Returns false if there is no such section.
+    static bool section_data(std::ifstream& fs, const char* section_name, std::vector<char>& ret) {
+        ret.clear();
+
+        std::vector<char> names;
+        sections_names_raw(fs, names);
+
+        const header_t elf = header(fs);
+        for (std::size_t i = 0; i < elf.e_shnum; ++i) {
+            section_t section;
+            fs.seekg(elf.e_shoff + i * sizeof(section_t));
+            read_raw(fs, section);
+
+            if (section.sh_name >= names.size() || std::strcmp(&names[0] + section.sh_name, section_name)) {
+                continue;
+            }
+
+            ret.resize(static_cast<std::size_t>(section.sh_size));
+            if (section.sh_type != SHT_NOBITS_ && !ret.empty()) {
+                fs.seekg(section.sh_offset);
+                read_raw(fs, ret[0], ret.size());
+            }
+
+            return true;
+        }
+
+        return false;
+    }
+
+    // Returns the GNU build-id as a hex string or an empty string if there is no build-id note.
+    static std::string build_id(std::ifstream& fs) {
+        std::vector<char> note;
+        if (!section_data(fs, ".note.gnu.build-id", note)) {
+            return std::string();
+        }
+
+        // Name size, descriptor size and type, followed by the name and the descriptor aligned to 4 bytes
+        boost::uint32_t note_header[3];
+        if (note.size() < sizeof(note_header)) {
+            return std::string();
+        }
+        std::memcpy(note_header, &note[0], sizeof(note_header));
+
+        const boost::uint32_t NT_GNU_BUILD_ID_ = 3;
+        const std::size_t desc_offset = sizeof(note_header) + ((static_cast<std::size_t>(note_header[0]) + 3) & ~static_cast<std::size_t>(3));
+        if (note_header[2] != NT_GNU_BUILD_ID_ || desc_offset > note.size() || note_header[1] > note.size() - desc_offset) {
+            return std::string();
+        }
+
+        static const char digits[] = "0123456789abcdef";
+        std::string ret;
+        ret.reserve(note_header[1] * 2);
+        for (std::size_t i = 0; i < note_header[1]; ++i) {
+            const unsigned char c = static_cast<unsigned char>(note[desc_offset + i]);
+            ret += digits[c >> 4];
+            ret += digits[c & 0xF];
+        }
+        return ret;
+    }
+
     static std::vector<std::string> symbols(std::ifstream& fs, const char* section_name) {
         std::vector<std::string> ret;
         
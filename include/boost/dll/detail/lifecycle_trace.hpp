@@ -0,0 +1,246 @@
+// Copyright 2020 Antony Polukhin.
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt
+// or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BOOST_DLL_DETAIL_LIFECYCLE_TRACE_HPP
+#define BOOST_DLL_DETAIL_LIFECYCLE_TRACE_HPP
+
+#include <boost/dll/config.hpp>
+#include <boost/dll/lifecycle_observer.hpp>
+#include <boost/predef/os.h>
+
+#include <atomic>
+#include <map>
+#include <memory>
+#include <mutex>
+
+#if BOOST_OS_WINDOWS
+#   include <boost/dll/detail/windows/shared_library_impl.hpp>
+#else
+#   include <boost/dll/detail/posix/shared_library_impl.hpp>
+#endif
+
+#ifdef BOOST_HAS_PRAGMA_ONCE
+# pragma once
+#endif
+
+// Helpers that report to the installed boost::dll::lifecycle_observer and collect the
+// per library data for boost::dll::stats(). Used only if BOOST_DLL_ENABLE_TRACING is defined.
+// Exceptions from observers are swallowed, because most of the traced functions are noexcept.
+
+namespace boost { namespace dll { namespace detail {
+
+// Set by boost::dll::set_stats_collection(). Without it the load durations and the resolved symbols are not
+// collected, so symbol lookups do not take the registry mutex. Instances are counted on load and unload anyway,
+// otherwise the counts would be wrong after the collection is toggled while libraries are loaded.
+inline std::atomic<bool>& stats_collection_flag() BOOST_NOEXCEPT {
+    static std::atomic<bool> enabled(false);
+    return enabled;
+}
+
+inline bool stats_collection_enabled() BOOST_NOEXCEPT {
+    return boost::dll::detail::stats_collection_flag().load(std::memory_order_relaxed);
+}
+
+struct trace_registry_entry {
+    std::size_t                                         instances;
+    boost::dll::lifecycle_observer::clock_type::duration load_duration;
+    std::size_t                                         resolved_symbols;
+    std::shared_ptr<const boost::dll::fs::path>         path; // resolved on the first load
+};
+
+// Keeps the data of libraries that are referenced by at least one shared_library.
+class trace_registry {
+    typedef boost::dll::lifecycle_observer::clock_type::duration duration_t;
+    typedef std::shared_ptr<const boost::dll::fs::path> path_ptr;
+
+    std::mutex mutex_;
+    std::map<const void*, trace_registry_entry> entries_;
+
+    trace_registry() {}
+
+public:
+    static trace_registry& instance() {
+        // Never destroyed, because shared_library instances with static storage
+        // duration could be unloaded after the destruction of the function local statics.
+        static trace_registry* const registry = new trace_registry();
+        return *registry;
+    }
+
+    // Duration is zero if the stats collection is disabled. Path is kept only from the first load of the library.
+    void on_load(const void* handle, duration_t duration, const path_ptr& path) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        trace_registry_entry& e = entries_[handle];
+        if (!e.instances++) {
+            e.load_duration = duration;
+            e.path = path;
+        }
+    }
+
+    // Returns the path of the library, the handle may be already invalid.
+    path_ptr on_unload(const void* handle) {
+        path_ptr path;
+        std::lock_guard<std::mutex> lock(mutex_);
+        const std::map<const void*, trace_registry_entry>::iterator it = entries_.find(handle);
+        if (it != entries_.end()) {
+            path = it->second.path;
+            if (!--it->second.instances) {
+                entries_.erase(it);
+            }
+        }
+        return path;
+    }
+
+    // Returns the path of the library, counts the symbol if `count` is true.
+    path_ptr on_symbol(const void* handle, bool count) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        const std::map<const void*, trace_registry_entry>::iterator it = entries_.find(handle);
+        if (it == entries_.end()) {
+            return path_ptr();
+        }
+
+        if (count) {
+            ++it->second.resolved_symbols;
+        }
+        return it->second.path;
+    }
+
+    bool find(const void* handle, trace_registry_entry& out) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        const std::map<const void*, trace_registry_entry>::const_iterator it = entries_.find(handle);
+        if (it == entries_.end()) {
+            return false;
+        }
+
+        out = it->second;
+        return true;
+    }
+};
+
+class lifecycle_trace_base {
+protected:
+    typedef boost::dll::lifecycle_observer::clock_type clock_type;
+    typedef boost::dll::detail::shared_library_impl::native_handle_t native_handle_t;
+
+    boost::dll::lifecycle_observer* const   observer_;
+    const clock_type::time_point            start_;
+
+    lifecycle_trace_base() BOOST_NOEXCEPT
+        : observer_(boost::dll::get_lifecycle_observer())
+        , start_(clock_type::now())
+    {}
+
+    clock_type::duration elapsed() const BOOST_NOEXCEPT {
+        return clock_type::now() - start_;
+    }
+
+    static const boost::dll::fs::path& path_or_empty(const std::shared_ptr<const boost::dll::fs::path>& path) {
+        static const boost::dll::fs::path empty;
+        return path ? *path : empty;
+    }
+};
+
+class load_trace: lifecycle_trace_base {
+    const boost::dll::fs::path&         lib_path_;
+    const boost::dll::load_mode::type   mode_;
+
+public:
+    load_trace(const boost::dll::fs::path& lib_path, boost::dll::load_mode::type mode) BOOST_NOEXCEPT
+        : lib_path_(lib_path)
+        , mode_(mode)
+    {
+        if (observer_) try {
+            observer_->on_load_begin(lib_path_, mode_, start_);
+        } catch (...) {}
+    }
+
+    void finish(native_handle_t handle, const boost::dll::fs::error_code& ec) const BOOST_NOEXCEPT {
+        const clock_type::duration duration = elapsed();
+        if (!ec && handle) try {
+            // Resolved once here, so that the symbol lookups and the unload report the path without asking the OS
+            boost::dll::fs::error_code path_ec;
+            boost::dll::detail::trace_registry::instance().on_load(
+                handle,
+                boost::dll::detail::stats_collection_enabled() ? duration : clock_type::duration::zero(),
+                std::make_shared<const boost::dll::fs::path>(boost::dll::detail::path_from_handle(handle, path_ec))
+            );
+        } catch (...) {}
+
+        if (observer_) try {
+            observer_->on_load_end(lib_path_, mode_, ec, start_, duration);
+        } catch (...) {}
+    }
+};
+
+class unload_trace: lifecycle_trace_base {
+    const native_handle_t   handle_;
+
+public:
+    explicit unload_trace(native_handle_t handle) BOOST_NOEXCEPT
+        : handle_(handle)
+    {}
+
+    void finish() const BOOST_NOEXCEPT {
+        if (!handle_) {
+            return;
+        }
+
+        std::shared_ptr<const boost::dll::fs::path> lib_path;
+        try {
+            lib_path = boost::dll::detail::trace_registry::instance().on_unload(handle_);
+        } catch (...) {}
+
+        if (observer_ && lib_path && !lib_path->empty()) try {
+            observer_->on_unload(*lib_path, start_, elapsed());
+        } catch (...) {}
+    }
+};
+
+class symbol_trace: lifecycle_trace_base {
+    const native_handle_t   handle_;
+    const char* const       symbol_name_;
+
+public:
+    symbol_trace(native_handle_t handle, const char* symbol_name) BOOST_NOEXCEPT
+        : handle_(handle)
+        , symbol_name_(symbol_name)
+    {}
+
+    void finish(bool found) const BOOST_NOEXCEPT {
+        const clock_type::duration duration = elapsed();
+        const bool count = found && boost::dll::detail::stats_collection_enabled();
+        if (!count && !observer_) {
+            return;
+        }
+
+        std::shared_ptr<const boost::dll::fs::path> lib_path;
+        try {
+            lib_path = boost::dll::detail::trace_registry::instance().on_symbol(handle_, count);
+        } catch (...) {}
+
+        if (observer_) try {
+            observer_->on_symbol(path_or_empty(lib_path), symbol_name_, found, start_, duration);
+        } catch (...) {}
+    }
+};
+
+class storage_trace: lifecycle_trace_base {
+    const boost::dll::fs::path& lib_path_;
+
+public:
+    explicit storage_trace(const boost::dll::fs::path& lib_path) BOOST_NOEXCEPT
+        : lib_path_(lib_path)
+    {}
+
+    void finish(std::size_t symbols_count) const BOOST_NOEXCEPT {
+        if (observer_) try {
+            observer_->on_storage_build(lib_path_, symbols_count, start_, elapsed());
+        } catch (...) {}
+    }
+};
+
+}}} // namespace boost::dll::detail
+
+#endif // BOOST_DLL_DETAIL_LIFECYCLE_TRACE_HPP
@@ -15,7 +15,10 @@
 #endif
 
 #include <algorithm>
+#include <cstring>
 #include <fstream>
+#include <string>
+#include <vector>
 
 #include <boost/cstdint.hpp>
 
@@ -265,6 +268,34 @@ private:
         }
     };
 
+    struct section_data_gather {
+        const char*                     section_name;
+        std::vector<char>&              ret;
+        bool&                           found;
+
+        void operator()(std::ifstream& fs) const {
+            segment_t segment;
+            read_raw(fs, segment);
+
+            section_t section;
+            for (std::size_t j = 0; j < segment.nsects && !found; ++j) {
+                read_raw(fs, section);
+                // Forcing `sectname` to end on '\0', see section_names_gather
+                section.segname[0] = '\0';
+                if (std::strcmp(section.sectname, section_name)) {
+                    continue;
+                }
+
+                found = true;
+                ret.resize(static_cast<std::size_t>(section.size));
+                if (section.offset && !ret.empty()) { // zero offset for zero filled sections
+                    fs.seekg(section.offset);
+                    read_raw(fs, ret[0], ret.size());
+                }
+            }
+        }
+    };
+
 public:
     static std::vector<std::string> sections(std::ifstream& fs) {
         std::vector<std::string> ret;
@@ -291,6 +322,15 @@ public:
         return ret;
     }
 
+    // Reads the content of the section. Returns false if there is no such section.
+    static bool section_data(std::ifstream& fs, const char* section_name, std::vector<char>& ret) {
+        ret.clear();
+        bool found = false;
+        section_data_gather f = { section_name, ret, found };
+        command_finder(fs, SEGMENT_CMD_NUMBER, f);
+        return found;
+    }
+
     static std::vector<std::string> symbols(std::ifstream& fs, const char* section_name) {
         // Not very optimal solution
         std::vector<std::string> ret = sections(fs);
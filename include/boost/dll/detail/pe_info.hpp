@@ -14,8 +14,11 @@
 # pragma once
 #endif
 
+#include <algorithm> // std::min
 #include <cstring>
 #include <fstream>
+#include <string>
+#include <vector>
 
 #include <boost/assert.hpp>
 #include <boost/cstdint.hpp>
@@ -295,6 +298,39 @@ public:
         return ret;
     }
 
+    // Reads the content of the section. Returns false if there is no such section.
+    static bool section_data(std::ifstream& fs, const char* section_name, std::vector<char>& ret) {
+        ret.clear();
+
+        const header_t h = header(fs);
+        section_t image_section_header;
+        char name_helper[section_t::IMAGE_SIZEOF_SHORT_NAME_ + 1];
+        std::memset(name_helper, 0, sizeof(name_helper));
+        for (std::size_t i = 0;i < h.FileHeader.NumberOfSections;++i) {
+            // There is no terminating null character if the string is exactly eight characters long
+            read_raw(fs, image_section_header);
+            std::memcpy(name_helper, image_section_header.Name, section_t::IMAGE_SIZEOF_SHORT_NAME_);
+            if (std::strcmp(section_name, name_helper)) {
+                continue;
+            }
+
+            // Raw data is padded to the file alignment, tail of the virtual size is zero filled.
+            const std::size_t size = image_section_header.Misc.VirtualSize
+                ? image_section_header.Misc.VirtualSize
+                : image_section_header.SizeOfRawData;
+            const std::size_t raw_size = (std::min)(size, static_cast<std::size_t>(image_section_header.SizeOfRawData));
+            ret.resize(size);
+            if (raw_size) {
+                fs.seekg(image_section_header.PointerToRawData);
+                read_raw(fs, ret[0], raw_size);
+            }
+
+            return true;
+        }
+
+        return false;
+    }
+
     static std::vector<std::string> symbols(std::ifstream& fs, const char* section_name) {
         std::vector<std::string> ret;
 
@@ -0,0 +1,235 @@
+// Copyright 2020 Antony Polukhin.
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt
+// or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BOOST_DLL_DETAIL_POSIX_LOADED_SECTION_HPP
+#define BOOST_DLL_DETAIL_POSIX_LOADED_SECTION_HPP
+
+#include <boost/dll/config.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/predef/os.h>
+
+#include <cstring>
+#include <vector>
+
+#if (BOOST_OS_LINUX && defined(__GLIBC__)) || BOOST_OS_BSD_FREE
+#   include <dlfcn.h>
+#   include <link.h>
+#   define BOOST_DLL_DETAIL_HAS_LOADED_SECTION
+#endif
+
+#ifdef BOOST_HAS_PRAGMA_ONCE
+# pragma once
+#endif
+
+namespace boost { namespace dll { namespace detail {
+
+#ifdef BOOST_DLL_DETAIL_HAS_LOADED_SECTION
+
+// Section bounds are taken from the ELF note that BOOST_DLL_ALIAS_SECTIONED emits for each section,
+// the note is found in the PT_NOTE segments of the loaded image. Names of the entries are taken from
+// the dynamic symbol table of the image, that is found via the PT_DYNAMIC segment of the module.
+class loaded_section {
+#if BOOST_OS_BSD_FREE
+    typedef Elf_Addr    addr_t;
+    typedef Elf_Dyn     dyn_t;
+    typedef Elf_Sym     sym_t;
+    typedef Elf_Phdr    phdr_t;
+#else
+    typedef ElfW(Addr)  addr_t;
+    typedef ElfW(Dyn)   dyn_t;
+    typedef ElfW(Sym)   sym_t;
+    typedef ElfW(Phdr)  phdr_t;
+#endif
+
+    const struct link_map*  lm_;
+    const sym_t*            symbols_;
+    const char*             strings_;
+    std::size_t             count_;
+
+    struct bounds_search {
+        const struct link_map*  lm;
+        const char*             section_name;
+        addr_t                  begin;
+        addr_t                  end;
+        bool                    found;
+    };
+
+    // Some platforms (FreeBSD, MIPS, RISC-V) do not relocate the entries of the dynamic section.
+    const void* relocated(addr_t ptr) const BOOST_NOEXCEPT {
+        return reinterpret_cast<const void*>(ptr < lm_->l_addr ? lm_->l_addr + ptr : ptr);
+    }
+
+    static std::size_t align4(std::size_t size) BOOST_NOEXCEPT {
+        return (size + 3) & ~static_cast<std::size_t>(3);
+    }
+
+    // Offsets in the note are relative to the fields that hold them
+    static addr_t from_offset(const char* field) BOOST_NOEXCEPT {
+        return reinterpret_cast<addr_t>(field) + *reinterpret_cast<const boost::int32_t*>(field);
+    }
+
+    static bool find_in_notes(const char* first, const char* last, bounds_search& search) BOOST_NOEXCEPT {
+        const std::size_t header_size = 3 * sizeof(boost::uint32_t);
+        while (static_cast<std::size_t>(last - first) >= header_size) {
+            const boost::uint32_t* const header = reinterpret_cast<const boost::uint32_t*>(first);
+            const char* const name = first + header_size;
+            const char* const desc = name + align4(header[0]);
+            first = desc + align4(header[1]);
+            if (first > last) {
+                return false;
+            }
+
+            // Description is the offsets of the bounds and the section name
+            if (header[2] != 1 || header[0] != sizeof("boostdll") || std::strcmp(name, "boostdll")
+                || header[1] <= 2 * sizeof(boost::int32_t)
+                || std::strcmp(desc + 2 * sizeof(boost::int32_t), search.section_name))
+            {
+                continue;
+            }
+
+            search.begin = from_offset(desc);
+            search.end = from_offset(desc + sizeof(boost::int32_t));
+            search.found = true;
+            return true;
+        }
+
+        return false;
+    }
+
+    static int bounds_callback(struct dl_phdr_info* info, std::size_t /*size*/, void* data) {
+        bounds_search& search = *static_cast<bounds_search*>(data);
+        const char* const name = info->dlpi_name ? info->dlpi_name : "";
+        const char* const lm_name = search.lm->l_name ? search.lm->l_name : "";
+        if (info->dlpi_addr != search.lm->l_addr || std::strcmp(name, lm_name)) {
+            return 0;
+        }
+
+        for (std::size_t i = 0; i < info->dlpi_phnum; ++i) {
+            const phdr_t& ph = info->dlpi_phdr[i];
+            if (ph.p_type != PT_NOTE) {
+                continue;
+            }
+
+            const char* const first = reinterpret_cast<const char*>(info->dlpi_addr + ph.p_vaddr);
+            if (find_in_notes(first, first + ph.p_memsz, search)) {
+                break;
+            }
+        }
+
+        return 1; // the module was found
+    }
+
+    static std::size_t gnu_hash_symbols_count(const boost::uint32_t* h) BOOST_NOEXCEPT {
+        const boost::uint32_t buckets_count = h[0];
+        const boost::uint32_t symbols_offset = h[1];
+        const boost::uint32_t bloom_size = h[2];
+        const boost::uint32_t* const buckets = reinterpret_cast<const boost::uint32_t*>(
+            reinterpret_cast<const addr_t*>(h + 4) + bloom_size
+        );
+        const boost::uint32_t* const chains = buckets + buckets_count;
+
+        boost::uint32_t last = 0;
+        for (boost::uint32_t i = 0; i < buckets_count; ++i) {
+            if (buckets[i] > last) {
+                last = buckets[i];
+            }
+        }
+
+        if (last < symbols_offset) {
+            return symbols_offset;
+        }
+
+        // Last symbol of the chain has the lowest bit set
+        while (!(chains[last - symbols_offset] & 1)) {
+            ++last;
+        }
+
+        return last + 1;
+    }
+
+public:
+    explicit loaded_section(void* handle) BOOST_NOEXCEPT
+        : lm_(0)
+        , symbols_(0)
+        , strings_(0)
+        , count_(0)
+    {
+        struct link_map* lm = 0;
+        if (dlinfo(handle, RTLD_DI_LINKMAP, &lm) != 0 || !lm || !lm->l_ld) {
+            return;
+        }
+        lm_ = lm;
+
+        const boost::uint32_t* hash = 0;
+        const boost::uint32_t* gnu_hash = 0;
+        for (const dyn_t* d = lm_->l_ld; d->d_tag != DT_NULL; ++d) {
+            switch (d->d_tag) {
+            case DT_SYMTAB:     symbols_ = static_cast<const sym_t*>(relocated(d->d_un.d_ptr)); break;
+            case DT_STRTAB:     strings_ = static_cast<const char*>(relocated(d->d_un.d_ptr)); break;
+            case DT_HASH:       hash = static_cast<const boost::uint32_t*>(relocated(d->d_un.d_ptr)); break;
+#ifdef DT_GNU_HASH
+            case DT_GNU_HASH:   gnu_hash = static_cast<const boost::uint32_t*>(relocated(d->d_un.d_ptr)); break;
+#endif
+            }
+        }
+
+        if (!symbols_ || !strings_) {
+            count_ = 0;
+        } else if (hash) {
+            count_ = hash[1];   // nchain
+        } else if (gnu_hash) {
+            count_ = gnu_hash_symbols_count(gnu_hash);
+        }
+    }
+
+    // Returns false if the section bounds are not known. Entry must be an aggregate of name and address.
+    template <class Entry>
+    bool entries(const char* section_name, std::vector<Entry>& ret) const {
+        ret.clear();
+        if (!lm_) {
+            return false;
+        }
+
+        bounds_search search = { lm_, section_name, 0, 0, false };
+        dl_iterate_phdr(&loaded_section::bounds_callback, &search);
+        if (!search.found) {
+            return false;
+        }
+
+        // Aliases are the exported pointers from the section
+        ret.reserve((search.end - search.begin) / sizeof(void*));
+        for (std::size_t i = 0; i < count_; ++i) {
+            const sym_t& s = symbols_[i];
+            const addr_t addr = lm_->l_addr + s.st_value;
+            if (!s.st_shndx || s.st_size != sizeof(void*) || addr < search.begin || addr >= search.end || !strings_[s.st_name]) {
+                continue;
+            }
+
+            const Entry e = { strings_ + s.st_name, *reinterpret_cast<void* const*>(addr) };
+            ret.push_back(e);
+        }
+
+        return true;
+    }
+};
+
+template <class Entry>
+inline bool loaded_section_entries(void* handle, const char* section_name, std::vector<Entry>& ret) {
+    return boost::dll::detail::loaded_section(handle).entries(section_name, ret);
+}
+
+#else
+
+template <class Entry>
+inline bool loaded_section_entries(void* /*handle*/, const char* /*section_name*/, std::vector<Entry>& /*ret*/) BOOST_NOEXCEPT {
+    return false;
+}
+
+#endif
+
+}}} // namespace boost::dll::detail
+
+#endif // BOOST_DLL_DETAIL_POSIX_LOADED_SECTION_HPP
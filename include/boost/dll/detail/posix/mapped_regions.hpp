@@ -0,0 +1,224 @@
+// Copyright 2020 Antony Polukhin.
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt
+// or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BOOST_DLL_DETAIL_POSIX_MAPPED_REGIONS_HPP
+#define BOOST_DLL_DETAIL_POSIX_MAPPED_REGIONS_HPP
+
+#include <boost/dll/config.hpp>
+#include <boost/dll/detail/system_error.hpp>
+#include <boost/predef/os.h>
+
+#include <cstdio>   // std::sscanf
+#include <cstring>  // std::strcmp
+#include <vector>
+
+#if BOOST_OS_LINUX || BOOST_OS_BSD_FREE
+#   include <dlfcn.h>
+#   include <link.h>    // dl_iterate_phdr, struct link_map
+#endif
+
+#if BOOST_OS_LINUX
+#   include <fstream>
+#   include <string>
+#elif BOOST_OS_BSD_FREE
+#   include <sys/mman.h> // mincore
+#   include <unistd.h>   // sysconf
+#endif
+
+#ifdef BOOST_HAS_PRAGMA_ONCE
+# pragma once
+#endif
+
+namespace boost { namespace dll { namespace detail {
+
+    struct mapped_region {
+        const void*     begin;
+        std::size_t     size;
+    };
+
+#if BOOST_OS_LINUX || BOOST_OS_BSD_FREE
+
+    struct mapped_regions_search {
+        const struct link_map*                              module;
+        std::vector<boost::dll::detail::mapped_region>*     regions;
+        bool                                                found;
+    };
+
+    inline int mapped_regions_callback(struct dl_phdr_info* info, std::size_t /*size*/, void* data) {
+        mapped_regions_search& search = *static_cast<mapped_regions_search*>(data);
+
+        // Both `l_name` and `dlpi_name` are empty strings for the executable itself.
+        const char* const lhs = search.module->l_name ? search.module->l_name : "";
+        const char* const rhs = info->dlpi_name ? info->dlpi_name : "";
+        if (search.module->l_addr != info->dlpi_addr || std::strcmp(lhs, rhs)) {
+            return 0;
+        }
+
+        for (std::size_t i = 0; i < info->dlpi_phnum; ++i) {
+            if (info->dlpi_phdr[i].p_type != PT_LOAD) {
+                continue;
+            }
+
+            const mapped_region region = {
+                reinterpret_cast<const void*>(info->dlpi_addr + info->dlpi_phdr[i].p_vaddr),
+                static_cast<std::size_t>(info->dlpi_phdr[i].p_memsz)
+            };
+            search.regions->push_back(region);
+        }
+
+        search.found = true;
+        return 1; // stop the iteration
+    }
+
+    // Fills `regions` with the PT_LOAD segments of the module referenced by `handle`.
+    inline void mapped_regions(void* handle, std::vector<boost::dll::detail::mapped_region>& regions, boost::dll::fs::error_code& ec) {
+        regions.clear();
+
+        // See path_from_handle() for the explanation of why `handle` is a `struct link_map*`
+        const struct link_map* link_map = 0;
+#if BOOST_OS_BSD_FREE
+        if (dlinfo(handle, RTLD_DI_LINKMAP, &link_map) < 0) {
+            link_map = 0;
+        }
+#else
+        link_map = static_cast<const struct link_map*>(handle);
+#endif
+        if (!link_map) {
+            boost::dll::detail::reset_dlerror();
+            ec = boost::dll::fs::make_error_code(
+                boost::dll::fs::errc::bad_file_descriptor
+            );
+
+            return;
+        }
+
+        mapped_regions_search search = { link_map, &regions, false };
+        dl_iterate_phdr(&boost::dll::detail::mapped_regions_callback, &search);
+
+        if (!search.found) {
+            ec = boost::dll::fs::make_error_code(
+                boost::dll::fs::errc::bad_file_descriptor
+            );
+        }
+    }
+
+#else // #if BOOST_OS_LINUX || BOOST_OS_BSD_FREE
+
+    inline void mapped_regions(void* /*handle*/, std::vector<boost::dll::detail::mapped_region>& regions, boost::dll::fs::error_code& ec) {
+        regions.clear();
+        ec = boost::dll::fs::make_error_code(
+            boost::dll::fs::errc::operation_not_supported
+        );
+    }
+
+#endif // #if BOOST_OS_LINUX || BOOST_OS_BSD_FREE
+
+    inline std::size_t mapped_size(void* handle, boost::dll::fs::error_code& ec) {
+        std::vector<boost::dll::detail::mapped_region> regions;
+        boost::dll::detail::mapped_regions(handle, regions, ec);
+
+        std::size_t size = 0;
+        for (std::size_t i = 0; i < regions.size(); ++i) {
+            size += regions[i].size;
+        }
+
+        return size;
+    }
+
+#if BOOST_OS_LINUX
+
+    // Sums the `Rss` and `*_Dirty` fields of the /proc/self/smaps mappings that intersect `regions`.
+    inline bool resident_size(const std::vector<boost::dll::detail::mapped_region>& regions, std::size_t& resident, std::size_t& dirty) {
+        resident = 0;
+        dirty = 0;
+
+        std::ifstream smaps("/proc/self/smaps");
+        if (!smaps) {
+            return false;
+        }
+
+        bool intersects = false;
+        std::string line;
+        while (std::getline(smaps, line)) {
+            unsigned long begin = 0, end = 0;
+            unsigned long kb = 0;
+            if (std::sscanf(line.c_str(), "%lx-%lx ", &begin, &end) == 2) {
+                intersects = false;
+                for (std::size_t i = 0; i < regions.size(); ++i) {
+                    const unsigned long r_begin = reinterpret_cast<unsigned long>(regions[i].begin);
+                    if (r_begin < end && begin < r_begin + regions[i].size) {
+                        intersects = true;
+                        break;
+                    }
+                }
+            } else if (!intersects) {
+                continue;
+            } else if (std::sscanf(line.c_str(), "Rss: %lu kB", &kb) == 1) {
+                resident += kb * 1024;
+            } else if (std::sscanf(line.c_str(), "Shared_Dirty: %lu kB", &kb) == 1
+                    || std::sscanf(line.c_str(), "Private_Dirty: %lu kB", &kb) == 1)
+            {
+                dirty += kb * 1024;
+            }
+        }
+
+        return true;
+    }
+
+#elif BOOST_OS_BSD_FREE
+
+    inline bool resident_size(const std::vector<boost::dll::detail::mapped_region>& regions, std::size_t& resident, std::size_t& dirty) {
+        resident = 0;
+        dirty = 0;
+
+        const std::size_t page = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+        std::size_t prev_end = 0;
+        std::vector<char> vec;
+        for (std::size_t i = 0; i < regions.size(); ++i) {
+            const std::size_t r_begin = reinterpret_cast<std::size_t>(regions[i].begin);
+
+            // Adjacent segments often share a page, do not count it twice.
+            std::size_t begin = r_begin / page * page;
+            const std::size_t end = (r_begin + regions[i].size + page - 1) / page * page;
+            if (begin < prev_end) {
+                begin = prev_end;
+            }
+            if (begin >= end) {
+                continue;
+            }
+            prev_end = end;
+
+            vec.resize((end - begin) / page);
+            if (::mincore(reinterpret_cast<void*>(begin), end - begin, &vec[0]) != 0) {
+                return false;
+            }
+
+            for (std::size_t j = 0; j < vec.size(); ++j) {
+                if (vec[j] & MINCORE_INCORE) {
+                    resident += page;
+                }
+                if (vec[j] & (MINCORE_MODIFIED | MINCORE_MODIFIED_OTHER)) {
+                    dirty += page;
+                }
+            }
+        }
+
+        return true;
+    }
+
+#else
+
+    inline bool resident_size(const std::vector<boost::dll::detail::mapped_region>& /*regions*/, std::size_t& resident, std::size_t& dirty) {
+        resident = 0;
+        dirty = 0;
+        return false;
+    }
+
+#endif
+
+}}} // namespace boost::dll::detail
+
+#endif // BOOST_DLL_DETAIL_POSIX_MAPPED_REGIONS_HPP
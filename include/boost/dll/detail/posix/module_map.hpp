@@ -0,0 +1,227 @@
+// Copyright 2020 Antony Polukhin.
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt
+// or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BOOST_DLL_DETAIL_POSIX_MODULE_MAP_HPP
+#define BOOST_DLL_DETAIL_POSIX_MODULE_MAP_HPP
+
+#include <boost/dll/config.hpp>
+#include <boost/predef/os.h>
+
+#include <string>
+
+#if BOOST_OS_LINUX && defined(__GLIBC__) && !defined(BOOST_NO_CXX11_HDR_MUTEX) && !defined(BOOST_NO_CXX11_HDR_ATOMIC)
+#   define BOOST_DLL_DETAIL_MODULE_MAP_ENABLED 1
+#else
+#   define BOOST_DLL_DETAIL_MODULE_MAP_ENABLED 0
+#endif
+
+#if BOOST_DLL_DETAIL_MODULE_MAP_ENABLED
+#   include <link.h>    // dl_iterate_phdr
+#   include <algorithm> // std::sort, std::upper_bound
+#   include <atomic>
+#   include <cstddef>   // offsetof
+#   include <mutex>
+#   include <vector>
+#endif
+
+#ifdef BOOST_HAS_PRAGMA_ONCE
+# pragma once
+#endif
+
+namespace boost { namespace dll { namespace detail {
+
+enum module_map_result {
+    module_map_found,
+    module_map_not_found,   // the address does not belong to any loaded module
+    module_map_unavailable  // the module map can not be used, dladdr() must be used instead
+};
+
+#if BOOST_DLL_DETAIL_MODULE_MAP_ENABLED
+
+// Sorted address ranges of all the loaded segments of all the loaded modules. Unlike dladdr()
+// it does not scan the symbol tables of the modules and does not call readlink(): lookups are
+// binary searches in an immutable snapshot.
+//
+// The snapshot is valid while the `dlpi_adds` and `dlpi_subs` counters of the C library are the
+// same as they were when it was built, so modules loaded or unloaded by any code are detected.
+// The counters are sampled from the first dl_iterate_phdr() callback, which stops the iteration.
+// Only a change of the counters rebuilds the snapshot, addresses outside of all the modules are
+// reported as not found without a rebuild.
+class module_map {
+    struct interval {
+        std::size_t begin;
+        std::size_t end;
+        std::size_t module;
+
+        bool operator<(const interval& rhs) const BOOST_NOEXCEPT {
+            return begin < rhs.begin;
+        }
+    };
+
+    struct counters {
+        unsigned long long  adds;
+        unsigned long long  subs;
+        bool                valid;
+
+        bool operator==(const counters& rhs) const BOOST_NOEXCEPT {
+            return valid && rhs.valid && adds == rhs.adds && subs == rhs.subs;
+        }
+    };
+
+    struct snapshot {
+        counters                    built;
+        std::vector<interval>       intervals;
+        std::vector<std::string>    names;
+    };
+
+    // Readers do not announce themselves, so a replaced snapshot could still be in use and is
+    // never freed. A snapshot is built only when the set of loaded modules changed, so the memory
+    // grows with the number of dlopen()/dlclose() calls, not with the number of lookups.
+    std::atomic<const snapshot*>    current_;
+
+    std::mutex                      refresh_mutex_;
+    std::vector<const snapshot*>    retired_;
+
+    module_map() BOOST_NOEXCEPT
+        : current_(0)
+    {}
+
+    static bool has_counters(std::size_t size) BOOST_NOEXCEPT {
+        return size >= offsetof(struct dl_phdr_info, dlpi_subs) + sizeof(static_cast<struct dl_phdr_info*>(0)->dlpi_subs);
+    }
+
+    static counters counters_from(const struct dl_phdr_info* info, std::size_t size) BOOST_NOEXCEPT {
+        counters c = { 0, 0, false };
+        if (has_counters(size)) {
+            c.adds = info->dlpi_adds;
+            c.subs = info->dlpi_subs;
+            c.valid = true;
+        }
+        return c;
+    }
+
+    static int counters_callback(struct dl_phdr_info* info, std::size_t size, void* data) {
+        *static_cast<counters*>(data) = module_map::counters_from(info, size);
+        return 1; // counters are the same for all the modules, stop the iteration
+    }
+
+    static int build_callback(struct dl_phdr_info* info, std::size_t size, void* data) {
+        snapshot& s = *static_cast<snapshot*>(data);
+        if (s.names.empty()) {
+            s.built = module_map::counters_from(info, size);
+        }
+
+        const std::size_t module = s.names.size();
+        s.names.push_back(info->dlpi_name ? info->dlpi_name : "");
+        for (std::size_t i = 0; i < info->dlpi_phnum; ++i) {
+            if (info->dlpi_phdr[i].p_type != PT_LOAD) {
+                continue;
+            }
+
+            const std::size_t begin = static_cast<std::size_t>(info->dlpi_addr + info->dlpi_phdr[i].p_vaddr);
+            const interval in = { begin, begin + static_cast<std::size_t>(info->dlpi_phdr[i].p_memsz), module };
+            s.intervals.push_back(in);
+        }
+
+        return 0;
+    }
+
+    static counters sample() BOOST_NOEXCEPT {
+        counters c = { 0, 0, false };
+        dl_iterate_phdr(&module_map::counters_callback, &c);
+        return c;
+    }
+
+    // Returns the snapshot that is valid for the counters `c`.
+    const snapshot* refresh(const counters& c) {
+        std::lock_guard<std::mutex> lock(refresh_mutex_);
+
+        // Other thread could have rebuilt the snapshot while this one waited for the mutex
+        const snapshot* old = current_.load(std::memory_order_acquire);
+        if (old && old->built == c) {
+            return old;
+        }
+
+        snapshot* s = new snapshot();
+        try {
+            dl_iterate_phdr(&module_map::build_callback, s);
+            std::sort(s->intervals.begin(), s->intervals.end());
+            retired_.reserve(retired_.size() + 1);
+        } catch (...) {
+            delete s;
+            throw;
+        }
+
+        if (old) {
+            retired_.push_back(old);
+        }
+        current_.store(s, std::memory_order_release);
+        return s;
+    }
+
+    static module_map*& instance_ptr() BOOST_NOEXCEPT {
+        static module_map* map = 0;
+        return map;
+    }
+
+    static void create_instance() {
+        instance_ptr() = new module_map();
+    }
+
+public:
+    static module_map& instance() {
+        // Never destroyed, to be usable from the destructors of objects with static storage duration.
+        //
+        // Not a lambda: the call_once helpers instantiated for a lambda are exported weak symbols with
+        // the same names in all the binaries, so the lambda of another binary could be called.
+        static std::once_flag flag;
+        std::call_once(flag, &module_map::create_instance);
+        return *instance_ptr();
+    }
+
+    // On success `name` is empty for the executable itself.
+    module_map_result find(const void* ptr, std::string& name) {
+        const counters c = module_map::sample();
+        if (!c.valid) {
+            return module_map_unavailable;
+        }
+
+        const snapshot* s = current_.load(std::memory_order_acquire);
+        if (!s || !(s->built == c)) {
+            s = refresh(c);
+        }
+
+        const interval key = { reinterpret_cast<std::size_t>(ptr), 0, 0 };
+        std::vector<interval>::const_iterator it = std::upper_bound(s->intervals.begin(), s->intervals.end(), key);
+        if (it == s->intervals.begin()) {
+            return module_map_not_found;
+        }
+
+        --it;
+        if (key.begin >= it->end) {
+            return module_map_not_found;
+        }
+
+        name = s->names[it->module];
+        return module_map_found;
+    }
+};
+
+inline module_map_result module_map_find(const void* ptr, std::string& name) {
+    return boost::dll::detail::module_map::instance().find(ptr, name);
+}
+
+#else
+
+inline module_map_result module_map_find(const void* /*ptr*/, std::string& /*name*/) BOOST_NOEXCEPT {
+    return module_map_unavailable;
+}
+
+#endif
+
+}}} // namespace boost::dll::detail
+
+#endif // BOOST_DLL_DETAIL_POSIX_MODULE_MAP_HPP
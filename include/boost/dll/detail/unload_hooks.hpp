@@ -0,0 +1,163 @@
+// Copyright 2020 Antony Polukhin.
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt
+// or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BOOST_DLL_DETAIL_UNLOAD_HOOKS_HPP
+#define BOOST_DLL_DETAIL_UNLOAD_HOOKS_HPP
+
+#include <boost/dll/config.hpp>
+
+#if !defined(BOOST_NO_CXX11_HDR_ATOMIC) && !defined(BOOST_NO_CXX11_HDR_FUNCTIONAL)
+#   include <atomic>
+#   include <functional>
+#   define BOOST_DLL_DETAIL_HAS_UNLOAD_HOOKS
+#endif
+
+#ifdef BOOST_HAS_PRAGMA_ONCE
+# pragma once
+#endif
+
+namespace boost { namespace dll { namespace detail {
+
+#ifdef BOOST_DLL_DETAIL_HAS_UNLOAD_HOOKS
+
+// Count of the shared_library instances that reference each native handle and the unload hooks
+// of the handle. Hooks are run by the instance that drops the count to zero, right before it
+// releases the handle.
+//
+// The count is kept for every loaded handle, because copies made before the first add() also
+// hold the library. The nodes of the handles form a lock-free list that only grows at the head:
+// a node is allocated on the first load of a handle and is reused by the later loads of the same
+// handle, so loads, copies and unloads take no locks and do not allocate after that. Storage for
+// the hooks is allocated only by add().
+class unload_hooks_registry {
+    struct hook_node {
+        std::function<void()>   hook;
+        hook_node*              next;
+    };
+
+    struct handle_node {
+        const void* const           handle;
+        std::atomic<std::size_t>    instances;
+        std::atomic<hook_node*>     hooks;      // most recently added first
+        handle_node*                next;       // immutable after the node is published
+
+        explicit handle_node(const void* h) BOOST_NOEXCEPT
+            : handle(h)
+            , instances(0)
+            , hooks(0)
+            , next(0)
+        {}
+    };
+
+    std::atomic<handle_node*> head_;
+
+    unload_hooks_registry() BOOST_NOEXCEPT
+        : head_(0)
+    {}
+
+    // Searches the nodes from `first` up to `last`, not including `last`.
+    static handle_node* find(const void* handle, handle_node* first, handle_node* last = 0) BOOST_NOEXCEPT {
+        for (; first != last; first = first->next) {
+            if (first->handle == handle) {
+                return first;
+            }
+        }
+        return 0;
+    }
+
+    handle_node& node(const void* handle) {
+        handle_node* const head = head_.load(std::memory_order_acquire);
+        handle_node* n = unload_hooks_registry::find(handle, head);
+        if (n) {
+            return *n;
+        }
+
+        n = new handle_node(handle);
+        n->next = head;
+        while (!head_.compare_exchange_weak(n->next, n, std::memory_order_acq_rel, std::memory_order_acquire)) {
+            // n->next is the new head now, other thread could have added a node for the same handle
+            handle_node* const other = unload_hooks_registry::find(handle, n->next, head);
+            if (other) {
+                delete n;
+                return *other;
+            }
+        }
+        return *n;
+    }
+
+    static void run(hook_node* hooks) BOOST_NOEXCEPT {
+        while (hooks) {
+            try {
+                hooks->hook();
+            } catch (...) {
+                // Exceptions are ignored, the library must be unloaded anyway
+            }
+
+            hook_node* const next = hooks->next;
+            delete hooks;
+            hooks = next;
+        }
+    }
+
+public:
+    static unload_hooks_registry& instance() {
+        // Never destroyed, because shared_library instances with static storage
+        // duration could be unloaded after the destruction of the function local statics.
+        static unload_hooks_registry* const registry = new unload_hooks_registry();
+        return *registry;
+    }
+
+    void on_load(const void* handle) {
+        node(handle).instances.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // Runs the hooks in reverse order of the add() calls if this was the last instance.
+    // Hooks added by the hooks are also run.
+    void on_unload(const void* handle) BOOST_NOEXCEPT {
+        handle_node* const n = unload_hooks_registry::find(handle, head_.load(std::memory_order_acquire));
+        if (!n || n->instances.fetch_sub(1, std::memory_order_acq_rel) != 1) {
+            return;
+        }
+
+        // Other thread could load the same library meanwhile, the rest
+        // of the hooks are run when its last instance is released.
+        while (!n->instances.load(std::memory_order_acquire)) {
+            hook_node* const hooks = n->hooks.exchange(0, std::memory_order_acquire);
+            if (!hooks) {
+                break;
+            }
+            unload_hooks_registry::run(hooks);
+        }
+    }
+
+    template <class F>
+    void add(const void* handle, const F& hook) {
+        hook_node* const h = new hook_node{std::function<void()>(hook), 0};
+
+        std::atomic<hook_node*>& hooks = node(handle).hooks;
+        h->next = hooks.load(std::memory_order_relaxed);
+        while (!hooks.compare_exchange_weak(h->next, h, std::memory_order_release, std::memory_order_relaxed)) {}
+    }
+};
+
+inline void unload_hooks_on_load(const void* handle) {
+    boost::dll::detail::unload_hooks_registry::instance().on_load(handle);
+}
+
+inline void unload_hooks_on_unload(const void* handle) BOOST_NOEXCEPT {
+    boost::dll::detail::unload_hooks_registry::instance().on_unload(handle);
+}
+
+#else
+
+inline void unload_hooks_on_load(const void* /*handle*/) BOOST_NOEXCEPT {}
+inline void unload_hooks_on_unload(const void* /*handle*/) BOOST_NOEXCEPT {}
+
+#endif
+
+}}} // namespace boost::dll::detail
+
+#endif // BOOST_DLL_DETAIL_UNLOAD_HOOKS_HPP
@@ -0,0 +1,68 @@
+// Copyright 2020 Antony Polukhin.
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt
+// or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BOOST_DLL_DETAIL_WINDOWS_MAPPED_REGIONS_HPP
+#define BOOST_DLL_DETAIL_WINDOWS_MAPPED_REGIONS_HPP
+
+#include <boost/dll/config.hpp>
+#include <boost/dll/detail/pe_info.hpp>
+#include <boost/type_traits/conditional.hpp>
+#include <boost/winapi/dll.hpp>
+
+#include <vector>
+
+#ifdef BOOST_HAS_PRAGMA_ONCE
+# pragma once
+#endif
+
+namespace boost { namespace dll { namespace detail {
+
+    struct mapped_region {
+        const void*     begin;
+        std::size_t     size;
+    };
+
+    // HMODULE is the address at which the image is mapped, so the PE headers of the
+    // module could be read directly from memory without touching the file.
+    inline void mapped_regions(boost::winapi::HMODULE_ handle, std::vector<boost::dll::detail::mapped_region>& regions, boost::dll::fs::error_code& ec) {
+        typedef boost::dll::detail::IMAGE_NT_HEADERS_template<
+            boost::conditional<sizeof(void*) == 8, boost::dll::detail::ULONGLONG_, boost::dll::detail::DWORD_>::type
+        > header_t;
+
+        regions.clear();
+        if (!handle) {
+            ec = boost::dll::fs::make_error_code(
+                boost::dll::fs::errc::bad_file_descriptor
+            );
+
+            return;
+        }
+
+        const char* const base = reinterpret_cast<const char*>(handle);
+        const boost::dll::detail::IMAGE_DOS_HEADER_& dos = *reinterpret_cast<const boost::dll::detail::IMAGE_DOS_HEADER_*>(base);
+        const header_t& h = *reinterpret_cast<const header_t*>(base + dos.e_lfanew);
+
+        const mapped_region region = { base, h.OptionalHeader.SizeOfImage };
+        regions.push_back(region);
+    }
+
+    inline std::size_t mapped_size(boost::winapi::HMODULE_ handle, boost::dll::fs::error_code& ec) {
+        std::vector<boost::dll::detail::mapped_region> regions;
+        boost::dll::detail::mapped_regions(handle, regions, ec);
+
+        return regions.empty() ? 0 : regions.front().size;
+    }
+
+    // Working set information requires psapi, which is not linked by Boost.DLL.
+    inline bool resident_size(const std::vector<boost::dll::detail::mapped_region>& /*regions*/, std::size_t& resident, std::size_t& dirty) {
+        resident = 0;
+        dirty = 0;
+        return false;
+    }
+
+}}} // namespace boost::dll::detail
+
+#endif // BOOST_DLL_DETAIL_WINDOWS_MAPPED_REGIONS_HPP
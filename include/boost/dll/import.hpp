@@ -86,6 +86,15 @@ namespace detail {
         typedef boost::shared_ptr<T> base_type;
         typedef boost::shared_ptr<T> type;
     };
+
+    inline void report_empty_library_ptr(const char* function) {
+        boost::throw_exception(
+            boost::dll::fs::system_error(
+                boost::dll::fs::make_error_code(boost::dll::fs::errc::bad_file_descriptor),
+                function
+            )
+        );
+    }
 } // namespace detail
 
 
@@ -178,6 +187,44 @@ BOOST_DLL_IMPORT_RESULT_TYPE import(BOOST_RV_REF(shared_library) lib, const std:
     return import<T>(boost::move(lib), name.c_str());
 }
 
+/*!
+* Same as \forcedlink{import}, but does not copy the library. Returned value shares the ownership of `lib`,
+* so that any count of imports from the same library do only one load and hold one reference count.
+*
+* \b Example:
+*
+* \code
+* boost::shared_ptr<shared_library> lib = boost::make_shared<shared_library>("test_lib.so");
+* auto f = import<int(int)>(lib, "integer_func_name");
+* auto g = import<int(int)>(lib, "other_func_name");
+* \endcode
+*
+* \b Template \b parameter \b T:    Type of the symbol that we are going to import. Must be explicitly specified.
+*
+* \param lib Shared pointer to the loaded library to import the symbol from.
+* \param name Null-terminated C or C++ mangled name of the function to import. Can handle std::string, char*, const char*.
+*
+* \return callable object if T is a function type, or boost::shared_ptr<T> if T is an object type.
+*
+* \throw \forcedlinkfs{system_error} if symbol does not exist, if `lib` is empty or if the DLL/DSO was not loaded.
+*/
+template <class T>
+BOOST_DLL_IMPORT_RESULT_TYPE import(const boost::shared_ptr<shared_library>& lib, const char* name) {
+    typedef typename boost::dll::detail::import_type<T>::base_type type;
+
+    if (!lib) {
+        boost::dll::detail::report_empty_library_ptr("boost::dll::import() failed: empty shared_ptr");
+    }
+
+    return type(lib, boost::addressof(lib->get<T>(name)));
+}
+
+//! \overload boost::dll::import(const boost::shared_ptr<shared_library>& lib, const char* name)
+template <class T>
+BOOST_DLL_IMPORT_RESULT_TYPE import(const boost::shared_ptr<shared_library>& lib, const std::string& name) {
+    return import<T>(lib, name.c_str());
+}
+
 
 
 
@@ -268,6 +315,36 @@ BOOST_DLL_IMPORT_RESULT_TYPE import_alias(BOOST_RV_REF(shared_library) lib, cons
     return import_alias<T>(boost::move(lib), name.c_str());
 }
 
+/*!
+* Same as \forcedlink{import_alias}, but does not copy the library. Returned value shares the ownership of `lib`,
+* so that any count of imports from the same library do only one load and hold one reference count.
+*
+* \b Template \b parameter \b T:    Type of the symbol alias that we are going to import. Must be explicitly specified.
+*
+* \param lib Shared pointer to the loaded library to import the symbol from.
+* \param name Null-terminated C or C++ mangled name of the function or variable to import. Can handle std::string, char*, const char*.
+*
+* \return callable object if T is a function type, or boost::shared_ptr<T> if T is an object type.
+*
+* \throw \forcedlinkfs{system_error} if symbol does not exist, if `lib` is empty or if the DLL/DSO was not loaded.
+*/
+template <class T>
+BOOST_DLL_IMPORT_RESULT_TYPE import_alias(const boost::shared_ptr<shared_library>& lib, const char* name) {
+    typedef typename boost::dll::detail::import_type<T>::base_type type;
+
+    if (!lib) {
+        boost::dll::detail::report_empty_library_ptr("boost::dll::import_alias() failed: empty shared_ptr");
+    }
+
+    return type(lib, lib->get<T*>(name));
+}
+
+//! \overload boost::dll::import_alias(const boost::shared_ptr<shared_library>& lib, const char* name)
+template <class T>
+BOOST_DLL_IMPORT_RESULT_TYPE import_alias(const boost::shared_ptr<shared_library>& lib, const std::string& name) {
+    return import_alias<T>(lib, name.c_str());
+}
+
 #undef BOOST_DLL_IMPORT_RESULT_TYPE
 
 
@@ -0,0 +1,505 @@
+// Copyright 2020 Antony Polukhin.
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt
+// or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BOOST_DLL_INSTRUMENTED_IMPORT_HPP
+#define BOOST_DLL_INSTRUMENTED_IMPORT_HPP
+
+/// \file boost/dll/instrumented_import.hpp
+/// \brief Contains the boost::dll::instrumented_import functions that return callables recording call counts,
+/// errors and latency histograms of the imported functions.
+
+#include <boost/dll/config.hpp>
+#include <boost/dll/shared_library.hpp>
+#include <boost/core/addressof.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/make_shared.hpp>
+#include <boost/move/move.hpp>
+#include <boost/noncopyable.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/static_assert.hpp>
+#include <boost/type_traits/is_function.hpp>
+
+#if defined(BOOST_NO_CXX11_HDR_CHRONO) || defined(BOOST_NO_CXX11_HDR_ATOMIC) || defined(BOOST_NO_CXX11_HDR_THREAD) \
+    || defined(BOOST_NO_CXX11_THREAD_LOCAL) || defined(BOOST_NO_CXX11_VARIADIC_TEMPLATES) || defined(BOOST_NO_CXX11_DECLTYPE) \
+    || defined(BOOST_NO_CXX11_TRAILING_RESULT_TYPES) || defined(BOOST_NO_CXX11_RVALUE_REFERENCES)
+#  error This file requires C++11 at least!
+#endif
+
+#include <atomic>
+#include <chrono>
+#include <functional>   // std::hash
+#include <ostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef BOOST_HAS_PRAGMA_ONCE
+# pragma once
+#endif
+
+#ifdef BOOST_DLL_DOXYGEN
+/// Define this macro to make the boost::dll::instrumented_function call the imported function exactly as
+/// boost::dll::import does, without recording anything and without allocating the metrics. Metrics stay zero.
+#define BOOST_DLL_DISABLE_INSTRUMENTATION BOOST_DLL_DISABLE_INSTRUMENTATION
+#endif
+
+namespace boost { namespace dll {
+
+/// @cond
+namespace detail {
+
+    // Log-linear buckets: 4 buckets for each power of two, so the relative error of a bucket bound is 25%.
+    BOOST_STATIC_CONSTANT(std::size_t, latency_sub_buckets_bits = 2);
+    BOOST_STATIC_CONSTANT(std::size_t, latency_sub_buckets = 1u << latency_sub_buckets_bits);
+    BOOST_STATIC_CONSTANT(std::size_t, latency_buckets = (64 - latency_sub_buckets_bits + 1) * latency_sub_buckets);
+
+    // Histogram bounds written by write_prometheus() are `2^i - 1` nanoseconds for `i` in this range, from
+    // about a microsecond to about a minute. Buckets are the same for all the functions and all the scrapes.
+    BOOST_STATIC_CONSTANT(std::size_t, prometheus_min_exponent = 10);
+    BOOST_STATIC_CONSTANT(std::size_t, prometheus_max_exponent = 36);
+
+    // Counters are striped, so that threads mostly increment their own cache lines.
+    BOOST_STATIC_CONSTANT(std::size_t, call_metrics_shards = 8);
+
+    inline std::size_t latency_bucket(boost::uint64_t ns) BOOST_NOEXCEPT {
+        if (ns < latency_sub_buckets) {
+            return static_cast<std::size_t>(ns);
+        }
+
+        std::size_t exponent = 0;
+        for (boost::uint64_t v = ns; v > 1; v >>= 1) {
+            ++exponent;
+        }
+
+        const std::size_t shift = exponent - latency_sub_buckets_bits;
+        return (shift + 1) * latency_sub_buckets + static_cast<std::size_t>((ns >> shift) & (latency_sub_buckets - 1));
+    }
+
+    inline boost::uint64_t latency_bucket_upper_bound(std::size_t bucket) BOOST_NOEXCEPT {
+        if (bucket < latency_sub_buckets) {
+            return bucket;
+        }
+
+        const std::size_t shift = bucket / latency_sub_buckets - 1;
+        const boost::uint64_t lower = static_cast<boost::uint64_t>(latency_sub_buckets + bucket % latency_sub_buckets) << shift;
+        return lower + ((static_cast<boost::uint64_t>(1) << shift) - 1);
+    }
+
+    inline std::size_t this_thread_metrics_shard() BOOST_NOEXCEPT {
+        static thread_local const std::size_t shard
+            = std::hash<std::thread::id>()(std::this_thread::get_id()) % call_metrics_shards;
+        return shard;
+    }
+
+    inline void write_prometheus_label(std::ostream& out, const std::string& s) {
+        for (std::size_t i = 0; i < s.size(); ++i) {
+            switch (s[i]) {
+            case '"':  out << "\\\""; break;
+            case '\\': out << "\\\\"; break;
+            case '\n': out << "\\n"; break;
+            default:   out << s[i];
+            }
+        }
+    }
+
+} // namespace detail
+/// @endcond
+
+
+/*!
+* \brief Copy of the metrics of an imported function returned by boost::dll::call_metrics::snapshot().
+*/
+struct call_metrics_snapshot {
+    /// Name of the imported function.
+    std::string                     name;
+
+    /// Count of the completed calls, including the calls that have thrown.
+    boost::uint64_t                 calls;
+
+    /// Count of the calls that have thrown.
+    boost::uint64_t                 errors;
+
+    /// Sum of the durations of all the calls.
+    std::chrono::nanoseconds        total;
+
+    /// Count of calls in each latency bucket. Bucket `i` holds the calls with durations in
+    /// range `(bucket_upper_bound(i - 1), bucket_upper_bound(i)]`.
+    std::vector<boost::uint64_t>    buckets;
+
+    call_metrics_snapshot()
+        : calls(0)
+        , errors(0)
+        , total(0)
+        , buckets(boost::dll::detail::latency_buckets, 0)
+    {}
+
+    /// \return Upper bound of the latency bucket `i`.
+    static std::chrono::nanoseconds bucket_upper_bound(std::size_t i) BOOST_NOEXCEPT {
+        return std::chrono::nanoseconds(
+            static_cast<std::chrono::nanoseconds::rep>(boost::dll::detail::latency_bucket_upper_bound(i))
+        );
+    }
+
+    /*!
+    * \param q Quantile in range [0, 1], for example 0.99.
+    * \return Upper bound of the bucket that contains the quantile `q`, or zero if there were no calls.
+    * The value is at most 25% greater than the exact quantile.
+    */
+    std::chrono::nanoseconds percentile(double q) const BOOST_NOEXCEPT {
+        if (!calls) {
+            return std::chrono::nanoseconds(0);
+        }
+
+        boost::uint64_t rank = static_cast<boost::uint64_t>(q * static_cast<double>(calls) + 0.5);
+        if (rank < 1) {
+            rank = 1;
+        } else if (rank > calls) {
+            rank = calls;
+        }
+
+        boost::uint64_t seen = 0;
+        for (std::size_t i = 0; i < buckets.size(); ++i) {
+            seen += buckets[i];
+            if (seen >= rank) {
+                return bucket_upper_bound(i);
+            }
+        }
+
+        return bucket_upper_bound(buckets.size() - 1);
+    }
+};
+
+/*!
+* Writes the snapshot in Prometheus text exposition format as `boost_dll_calls_total`,
+* `boost_dll_call_errors_total` and the `boost_dll_call_duration_seconds` histogram
+* with the `function` label. The histogram has the same fixed set of bucket bounds for all the snapshots:
+* `2^i - 1` nanoseconds for `i` from 10 to 36, which is from about a microsecond to about a minute.
+*
+* \param out Stream to write into.
+* \param s Snapshot to write.
+* \throw Whatever `out` throws.
+*/
+inline void write_prometheus(std::ostream& out, const call_metrics_snapshot& s) {
+    const auto label = [&out, &s]() {
+        out << "{function=\"";
+        boost::dll::detail::write_prometheus_label(out, s.name);
+        out << '"';
+    };
+
+    out << "boost_dll_calls_total";
+    label();
+    out << "} " << s.calls << '\n';
+
+    out << "boost_dll_call_errors_total";
+    label();
+    out << "} " << s.errors << '\n';
+
+    boost::uint64_t cumulative = 0;
+    std::size_t next = 0;
+    for (std::size_t e = boost::dll::detail::prometheus_min_exponent; e <= boost::dll::detail::prometheus_max_exponent; ++e) {
+        const std::size_t last = boost::dll::detail::latency_bucket((static_cast<boost::uint64_t>(1) << e) - 1);
+        for (; next <= last && next < s.buckets.size(); ++next) {
+            cumulative += s.buckets[next];
+        }
+
+        out << "boost_dll_call_duration_seconds_bucket";
+        label();
+        out << ",le=\"" << static_cast<double>(boost::dll::detail::latency_bucket_upper_bound(last)) * 1e-9 << "\"} "
+            << cumulative << '\n';
+    }
+
+    out << "boost_dll_call_duration_seconds_bucket";
+    label();
+    out << ",le=\"+Inf\"} " << s.calls << '\n';
+
+    out << "boost_dll_call_duration_seconds_sum";
+    label();
+    out << "} " << static_cast<double>(s.total.count()) * 1e-9 << '\n';
+
+    out << "boost_dll_call_duration_seconds_count";
+    label();
+    out << "} " << s.calls << '\n';
+}
+
+
+/*!
+* \brief Lock-free counters and latency histogram of an imported function, shared by all the copies
+* of the boost::dll::instrumented_function.
+*
+* Counters are split into stripes, each thread increments the counters of its own stripe with relaxed atomics.
+* snapshot() sums the stripes and could be called concurrently with the calls.
+*/
+class call_metrics: private boost::noncopyable {
+    struct shard {
+        std::atomic<boost::uint64_t> calls;
+        std::atomic<boost::uint64_t> errors;
+        std::atomic<boost::uint64_t> total_ns;
+        std::atomic<boost::uint64_t> buckets[boost::dll::detail::latency_buckets];
+        char padding[64]; // keeps the hot counters of neighbour shards in different cache lines
+    };
+
+    const std::string   name_;
+    shard               shards_[boost::dll::detail::call_metrics_shards];
+
+public:
+    /// Creates zeroed metrics for the function `name`.
+    explicit call_metrics(std::string name)
+        : name_(boost::move(name))
+    {
+        reset();
+    }
+
+    /// \return Name of the imported function.
+    const std::string& name() const BOOST_NOEXCEPT {
+        return name_;
+    }
+
+    /*!
+    * Records a completed call.
+    *
+    * \param duration Duration of the call.
+    * \param failed true if the call has thrown.
+    * \throw Nothing.
+    */
+    void record(std::chrono::nanoseconds duration, bool failed) BOOST_NOEXCEPT {
+        const boost::uint64_t ns = duration.count() > 0 ? static_cast<boost::uint64_t>(duration.count()) : 0;
+        shard& s = shards_[boost::dll::detail::this_thread_metrics_shard()];
+        s.calls.fetch_add(1, std::memory_order_relaxed);
+        if (failed) {
+            s.errors.fetch_add(1, std::memory_order_relaxed);
+        }
+        s.total_ns.fetch_add(ns, std::memory_order_relaxed);
+        s.buckets[boost::dll::detail::latency_bucket(ns)].fetch_add(1, std::memory_order_relaxed);
+    }
+
+    /*!
+    * \return Sum of all the stripes. Calls that are recorded concurrently may be partially visible.
+    * \throw std::bad_alloc in case of insufficient memory.
+    */
+    call_metrics_snapshot snapshot() const {
+        call_metrics_snapshot ret;
+        ret.name = name_;
+
+        boost::uint64_t total_ns = 0;
+        for (std::size_t i = 0; i < boost::dll::detail::call_metrics_shards; ++i) {
+            const shard& s = shards_[i];
+            ret.calls += s.calls.load(std::memory_order_relaxed);
+            ret.errors += s.errors.load(std::memory_order_relaxed);
+            total_ns += s.total_ns.load(std::memory_order_relaxed);
+            for (std::size_t j = 0; j < boost::dll::detail::latency_buckets; ++j) {
+                ret.buckets[j] += s.buckets[j].load(std::memory_order_relaxed);
+            }
+        }
+        ret.total = std::chrono::nanoseconds(static_cast<std::chrono::nanoseconds::rep>(total_ns));
+
+        return ret;
+    }
+
+    /// Zeroes all the counters. \throw Nothing.
+    void reset() BOOST_NOEXCEPT {
+        for (std::size_t i = 0; i < boost::dll::detail::call_metrics_shards; ++i) {
+            shard& s = shards_[i];
+            s.calls.store(0, std::memory_order_relaxed);
+            s.errors.store(0, std::memory_order_relaxed);
+            s.total_ns.store(0, std::memory_order_relaxed);
+            for (std::size_t j = 0; j < boost::dll::detail::latency_buckets; ++j) {
+                s.buckets[j].store(0, std::memory_order_relaxed);
+            }
+        }
+    }
+};
+
+
+#ifdef BOOST_DLL_DISABLE_INSTRUMENTATION
+/// @cond
+namespace detail {
+    inline call_metrics& disabled_call_metrics() BOOST_NOEXCEPT {
+        static call_metrics metrics((std::string()));
+        return metrics;
+    }
+} // namespace detail
+/// @endcond
+#endif
+
+/*!
+* \brief Callable returned by boost::dll::instrumented_import. Refcounts the library like the callable
+* returned by boost::dll::import and records each call into the boost::dll::call_metrics.
+*
+* Copies share the same metrics.
+*/
+template <class T>
+class instrumented_function {
+    BOOST_STATIC_ASSERT_MSG(boost::is_function<T>::value, "boost::dll::instrumented_function works only with functions");
+
+    boost::shared_ptr<T>                    f_;
+
+#ifndef BOOST_DLL_DISABLE_INSTRUMENTATION
+    boost::shared_ptr<call_metrics>         metrics_;
+
+    struct call_guard {
+        call_metrics& metrics;
+        const std::chrono::steady_clock::time_point start;
+        bool failed;
+
+        ~call_guard() {
+            metrics.record(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start),
+                failed
+            );
+        }
+    };
+#endif
+
+public:
+    /*!
+    * \param lib Library that holds the function.
+    * \param func_ptr Function from the `lib`.
+    * \param name Name of the function for the metrics.
+    * \throw std::bad_alloc in case of insufficient memory.
+    */
+    instrumented_function(const boost::shared_ptr<shared_library>& lib, T* func_ptr, std::string name)
+        : f_(lib, func_ptr)
+#ifndef BOOST_DLL_DISABLE_INSTRUMENTATION
+        , metrics_(boost::make_shared<call_metrics>(boost::move(name)))
+#endif
+    {
+#ifdef BOOST_DLL_DISABLE_INSTRUMENTATION
+        (void)name;
+#endif
+    }
+
+    /// \return Metrics of the function, shared by all the copies of this instrumented_function.
+    /// If \forcedmacrolink{BOOST_DLL_DISABLE_INSTRUMENTATION} is defined, returns metrics with an empty name that
+    /// are shared by all the functions and are never recorded into.
+    call_metrics& metrics() const BOOST_NOEXCEPT {
+#ifndef BOOST_DLL_DISABLE_INSTRUMENTATION
+        return *metrics_;
+#else
+        return boost::dll::detail::disabled_call_metrics();
+#endif
+    }
+
+    /// \return Same as `metrics().snapshot()`.
+    call_metrics_snapshot snapshot() const {
+        return metrics().snapshot();
+    }
+
+    // Compilation error at this point means that imported function
+    // was called with unmatching parameters.
+    template <class... Args>
+    inline auto operator()(Args&&... args) const
+        -> decltype( (*f_)(static_cast<Args&&>(args)...) )
+    {
+#ifndef BOOST_DLL_DISABLE_INSTRUMENTATION
+        // Duration is recorded by the destructor, after the result was constructed
+        call_guard guard = { *metrics_, std::chrono::steady_clock::now(), false };
+        try {
+            return (*f_)(static_cast<Args&&>(args)...);
+        } catch (...) {
+            guard.failed = true;
+            throw;
+        }
+#else
+        return (*f_)(static_cast<Args&&>(args)...);
+#endif
+    }
+};
+
+
+/*!
+* Same as \forcedlink{import} for functions, but the returned callable records count of calls, count of
+* calls that have thrown and latency histogram of the calls. Metrics are available via
+* boost::dll::instrumented_function::snapshot().
+*
+* If \forcedmacrolink{BOOST_DLL_DISABLE_INSTRUMENTATION} is defined calls are not recorded and are done
+* exactly as by the callable from boost::dll::import.
+*
+* \b Example:
+* \code
+* auto f = boost::dll::instrumented_import<int(int)>("libmy_plugin.so", "process");
+* f(42);
+* boost::dll::write_prometheus(std::cout, f.snapshot());
+* \endcode
+*
+* \b Template \b parameter \b T:    Type of the function that we are going to import. Must be explicitly specified.
+*
+* \param lib Path to shared library or shared library to load function from.
+* \param name Null-terminated C or C++ mangled name of the function to import. Can handle std::string, char*, const char*.
+* \param mode An mode that will be used on library load.
+*
+* \return boost::dll::instrumented_function<T>.
+*
+* \throw \forcedlinkfs{system_error} if symbol does not exist or if the DLL/DSO was not loaded.
+*       std::bad_alloc in case of insufficient memory.
+*/
+template <class T>
+inline instrumented_function<T> instrumented_import(const boost::dll::fs::path& lib, const char* name,
+    load_mode::type mode = load_mode::default_mode)
+{
+    boost::shared_ptr<boost::dll::shared_library> p = boost::make_shared<boost::dll::shared_library>(lib, mode);
+    return instrumented_function<T>(p, boost::addressof(p->get<T>(name)), name);
+}
+
+//! \overload boost::dll::instrumented_import(const boost::dll::fs::path& lib, const char* name, load_mode::type mode)
+template <class T>
+inline instrumented_function<T> instrumented_import(const boost::dll::fs::path& lib, const std::string& name,
+    load_mode::type mode = load_mode::default_mode)
+{
+    return boost::dll::instrumented_import<T>(lib, name.c_str(), mode);
+}
+
+//! \overload boost::dll::instrumented_import(const boost::dll::fs::path& lib, const char* name, load_mode::type mode)
+template <class T>
+inline instrumented_function<T> instrumented_import(const shared_library& lib, const char* name) {
+    boost::shared_ptr<boost::dll::shared_library> p = boost::make_shared<boost::dll::shared_library>(lib);
+    return instrumented_function<T>(p, boost::addressof(p->get<T>(name)), name);
+}
+
+//! \overload boost::dll::instrumented_import(const boost::dll::fs::path& lib, const char* name, load_mode::type mode)
+template <class T>
+inline instrumented_function<T> instrumented_import(const shared_library& lib, const std::string& name) {
+    return boost::dll::instrumented_import<T>(lib, name.c_str());
+}
+
+//! \overload boost::dll::instrumented_import(const boost::dll::fs::path& lib, const char* name, load_mode::type mode)
+template <class T>
+inline instrumented_function<T> instrumented_import(BOOST_RV_REF(shared_library) lib, const char* name) {
+    boost::shared_ptr<boost::dll::shared_library> p = boost::make_shared<boost::dll::shared_library>(
+        boost::move(lib)
+    );
+    return instrumented_function<T>(p, boost::addressof(p->get<T>(name)), name);
+}
+
+//! \overload boost::dll::instrumented_import(const boost::dll::fs::path& lib, const char* name, load_mode::type mode)
+template <class T>
+inline instrumented_function<T> instrumented_import(BOOST_RV_REF(shared_library) lib, const std::string& name) {
+    return boost::dll::instrumented_import<T>(boost::move(lib), name.c_str());
+}
+
+//! \overload boost::dll::instrumented_import(const boost::dll::fs::path& lib, const char* name, load_mode::type mode)
+template <class T>
+inline instrumented_function<T> instrumented_import(const boost::shared_ptr<shared_library>& lib, const char* name) {
+    if (!lib) {
+        boost::throw_exception(
+            boost::dll::fs::system_error(
+                boost::dll::fs::make_error_code(boost::dll::fs::errc::bad_file_descriptor),
+                "boost::dll::instrumented_import() failed: empty shared_ptr"
+            )
+        );
+    }
+
+    return instrumented_function<T>(lib, boost::addressof(lib->get<T>(name)), name);
+}
+
+//! \overload boost::dll::instrumented_import(const boost::dll::fs::path& lib, const char* name, load_mode::type mode)
+template <class T>
+inline instrumented_function<T> instrumented_import(const boost::shared_ptr<shared_library>& lib, const std::string& name) {
+    return boost::dll::instrumented_import<T>(lib, name.c_str());
+}
+
+}} // boost::dll
+
+#endif // BOOST_DLL_INSTRUMENTED_IMPORT_HPP
@@ -0,0 +1,131 @@
+// Copyright 2020 Antony Polukhin.
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt
+// or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BOOST_DLL_LIBRARY_ANCHOR_HPP
+#define BOOST_DLL_LIBRARY_ANCHOR_HPP
+
+/// \file boost/dll/library_anchor.hpp
+/// \brief Contains the boost::dll::library_anchor class, an intrusively refcounted owner of a loaded library
+/// that objects created by the library could hold.
+
+#include <boost/dll/config.hpp>
+#include <boost/dll/shared_library.hpp>
+#include <boost/move/move.hpp>
+#include <boost/noncopyable.hpp>
+#include <boost/smart_ptr/intrusive_ptr.hpp>
+#include <boost/smart_ptr/intrusive_ref_counter.hpp>
+
+#ifdef BOOST_HAS_PRAGMA_ONCE
+# pragma once
+#endif
+
+namespace boost { namespace dll {
+
+/*!
+* \brief Keeps a library loaded while there are boost::dll::library_anchor_ptr pointers to it.
+*
+* Library is loaded once, when the anchor is constructed. After that keeping the library alive costs one atomic
+* increment per object: objects created by the library or deleters of their smart pointers hold a copy
+* of boost::dll::library_anchor_ptr, instead of a copy of boost::dll::shared_library or a
+* `boost::shared_ptr<boost::dll::shared_library>` created for each object.
+*
+* Library is unloaded when the last boost::dll::library_anchor_ptr is destroyed.
+*
+* \b Example:
+* \code
+* struct anchor_holding_deleter {
+*     boost::dll::library_anchor_ptr anchor;
+*
+*     void operator()(my_plugin_api* p) const {
+*         delete p; // runs before the `anchor` is released
+*     }
+* };
+*
+* boost::dll::library_anchor_ptr anchor = boost::dll::make_library_anchor("libmy_plugin.so");
+* my_plugin_api*(&create)() = anchor->library().get_alias<my_plugin_api*()>("create_plugin");
+*
+* std::vector<boost::shared_ptr<my_plugin_api> > plugins;
+* for (int i = 0; i < 1000000; ++i) {
+*     anchor_holding_deleter deleter = { anchor };
+*     plugins.push_back(boost::shared_ptr<my_plugin_api>(create(), deleter));
+* }
+* \endcode
+*/
+class library_anchor
+    : public boost::intrusive_ref_counter<library_anchor, boost::thread_safe_counter>
+    , private boost::noncopyable
+{
+    boost::dll::shared_library lib_;
+
+public:
+    /*!
+    * Loads a library by specified path with a specified mode.
+    *
+    * \param lib_path Library file name. Can handle std::string, const char*, std::wstring,
+    *           const wchar_t* or \forcedlinkfs{path}.
+    * \param mode A mode that will be used on library load.
+    * \throw \forcedlinkfs{system_error}, std::bad_alloc in case of insufficient memory.
+    */
+    explicit library_anchor(const boost::dll::fs::path& lib_path, load_mode::type mode = load_mode::default_mode)
+        : lib_(lib_path, mode)
+    {}
+
+    /*!
+    * Shares the library with `lib`.
+    *
+    * \param lib A library to copy.
+    * \throw \forcedlinkfs{system_error}, std::bad_alloc in case of insufficient memory.
+    */
+    explicit library_anchor(const boost::dll::shared_library& lib)
+        : lib_(lib)
+    {}
+
+    /*!
+    * Takes the library from `lib`.
+    *
+    * \param lib A library to move from.
+    * \throw Nothing.
+    */
+    explicit library_anchor(BOOST_RV_REF(boost::dll::shared_library) lib) BOOST_NOEXCEPT
+        : lib_(boost::move(lib))
+    {}
+
+    /// \return Underlying library.
+    const boost::dll::shared_library& library() const BOOST_NOEXCEPT {
+        return lib_;
+    }
+};
+
+/// Pointer that keeps the library of the boost::dll::library_anchor loaded. Copying costs one atomic increment.
+typedef boost::intrusive_ptr<library_anchor> library_anchor_ptr;
+
+
+/*!
+* Creates a boost::dll::library_anchor.
+*
+* \param lib_path Library file name. Can handle std::string, const char*, std::wstring,
+*           const wchar_t* or \forcedlinkfs{path}.
+* \param mode A mode that will be used on library load.
+* \return Pointer to the new anchor.
+* \throw \forcedlinkfs{system_error}, std::bad_alloc in case of insufficient memory.
+*/
+inline library_anchor_ptr make_library_anchor(const boost::dll::fs::path& lib_path, load_mode::type mode = load_mode::default_mode) {
+    return library_anchor_ptr(new library_anchor(lib_path, mode));
+}
+
+//! \overload library_anchor_ptr make_library_anchor(const boost::dll::fs::path& lib_path, load_mode::type mode)
+inline library_anchor_ptr make_library_anchor(const boost::dll::shared_library& lib) {
+    return library_anchor_ptr(new library_anchor(lib));
+}
+
+//! \overload library_anchor_ptr make_library_anchor(const boost::dll::fs::path& lib_path, load_mode::type mode)
+inline library_anchor_ptr make_library_anchor(BOOST_RV_REF(boost::dll::shared_library) lib) {
+    return library_anchor_ptr(new library_anchor(boost::move(lib)));
+}
+
+}} // boost::dll
+
+#endif // BOOST_DLL_LIBRARY_ANCHOR_HPP
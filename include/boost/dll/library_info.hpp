@@ -9,14 +9,17 @@
 #define BOOST_DLL_LIBRARY_INFO_HPP
 
 #include <boost/dll/config.hpp>
+#include <boost/dll/manifest.hpp>
 #include <boost/assert.hpp>
 #include <boost/noncopyable.hpp>
+#include <boost/optional/optional.hpp>
 #include <boost/predef/os.h>
 #include <boost/predef/architecture.h>
 #include <boost/throw_exception.hpp>
 #include <boost/type_traits/integral_constant.hpp>
 
 #include <fstream>
+#include <vector>
 
 #include <boost/dll/detail/pe_info.hpp>
 #include <boost/dll/detail/elf_info.hpp>
@@ -32,6 +35,8 @@
 
 namespace boost { namespace dll {
 
+namespace detail { struct mangled_storage_base; }
+
 /*!
 * \brief Class that is capable of extracting different information from a library or binary file.
 * Currently understands ELF, MACH-O and PE formats on all the platforms.
@@ -39,6 +44,7 @@ namespace boost { namespace dll {
 class library_info: private boost::noncopyable {
 private:
     std::ifstream f_;
+    boost::dll::fs::path path_;
 
     enum {
         fmt_elf_info32,
@@ -50,6 +56,9 @@ private:
     } fmt_;
 
     /// @cond
+    // Keys the cache of the symbol tables by the file.
+    friend struct boost::dll::detail::mangled_storage_base;
+
     inline static void throw_if_in_32bit_impl(boost::true_type /* is_32bit_platform */) {
         boost::throw_exception(std::runtime_error("Not native format: 64bit binary"));
     }
@@ -130,6 +139,7 @@ public:
         #endif
             std::ios_base::in | std::ios_base::binary
         )
+        , path_(library_path)
     {
         f_.exceptions(
             std::ios_base::failbit
@@ -203,6 +213,54 @@ public:
         BOOST_ASSERT(false);
         BOOST_UNREACHABLE_RETURN(std::vector<std::string>())
     }
+
+    /*!
+    * Build-id identifies the build of a binary. Binaries with the same build-id may still differ, for example
+    * a stripped copy of a binary keeps the build-id of the original.
+    *
+    * \return Build-id of the binary as a lowercase hex string or an empty string if the binary has no build-id.
+    * Only GNU build-id notes of ELF binaries are supported, the result is always empty for PE and Mach-O binaries.
+    * \throw std::ios_base::failure if the file is broken, std::bad_alloc in case of insufficient memory.
+    */
+    std::string build_id() {
+        switch (fmt_) {
+        case fmt_elf_info32:   return boost::dll::detail::elf_info32::build_id(f_);
+        case fmt_elf_info64:   return boost::dll::detail::elf_info64::build_id(f_);
+        case fmt_pe_info32:
+        case fmt_pe_info64:
+        case fmt_macho_info32:
+        case fmt_macho_info64: return std::string();
+        };
+        BOOST_ASSERT(false);
+        BOOST_UNREACHABLE_RETURN(std::string())
+    }
+
+    /*!
+    * Reads the record written by \forcedmacrolink{BOOST_DLL_MANIFEST} directly from the file. The binary is not
+    * loaded and none of its code is executed.
+    *
+    * \return Manifest of the binary or empty optional if the binary has no manifest.
+    * \throw std::ios_base::failure if the file is broken, std::bad_alloc in case of insufficient memory.
+    */
+    boost::optional<boost::dll::plugin_manifest> manifest() {
+        std::vector<char> data;
+        bool found = false;
+        switch (fmt_) {
+        case fmt_elf_info32:   found = boost::dll::detail::elf_info32::section_data(f_, "boostmnf", data); break;
+        case fmt_elf_info64:   found = boost::dll::detail::elf_info64::section_data(f_, "boostmnf", data); break;
+        case fmt_pe_info32:    found = boost::dll::detail::pe_info32::section_data(f_, "boostmnf", data); break;
+        case fmt_pe_info64:    found = boost::dll::detail::pe_info64::section_data(f_, "boostmnf", data); break;
+        case fmt_macho_info32: found = boost::dll::detail::macho_info32::section_data(f_, "boostmnf", data); break;
+        case fmt_macho_info64: found = boost::dll::detail::macho_info64::section_data(f_, "boostmnf", data); break;
+        };
+
+        boost::dll::plugin_manifest ret;
+        if (!found || !boost::dll::detail::parse_manifest(data, ret)) {
+            return boost::none;
+        }
+
+        return ret;
+    }
 };
 
 }} // namespace boost::dll
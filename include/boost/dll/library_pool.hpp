@@ -0,0 +1,377 @@
+// Copyright 2020 Antony Polukhin.
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt
+// or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BOOST_DLL_LIBRARY_POOL_HPP
+#define BOOST_DLL_LIBRARY_POOL_HPP
+
+/// \file boost/dll/library_pool.hpp
+/// \brief Contains the boost::dll::library_pool class that keeps recently used libraries loaded.
+
+#include <boost/dll/config.hpp>
+#include <boost/dll/shared_library.hpp>
+#include <boost/make_shared.hpp>
+#include <boost/noncopyable.hpp>
+#include <boost/predef/os.h>
+#include <boost/shared_ptr.hpp>
+#include <boost/weak_ptr.hpp>
+
+#if BOOST_OS_WINDOWS
+#   include <boost/dll/detail/windows/mapped_regions.hpp>
+#else
+#   include <boost/dll/detail/posix/mapped_regions.hpp>
+#endif
+
+#ifdef BOOST_NO_CXX11_HDR_MUTEX
+#  error This file requires C++11 at least!
+#endif
+
+#include <list>
+#include <map>
+#include <mutex>
+#include <utility>  // std::pair
+#include <vector>
+
+#ifdef BOOST_HAS_PRAGMA_ONCE
+# pragma once
+#endif
+
+namespace boost { namespace dll {
+
+/// @cond
+namespace detail {
+
+    // State is shared with the deleters of the handed out handles, so that the handles
+    // remain valid after the destruction of the pool.
+    class library_pool_state: private boost::noncopyable {
+    public:
+        typedef std::pair<boost::dll::fs::path, load_mode::type> key_t;
+        typedef boost::shared_ptr<boost::dll::shared_library> library_ptr_t;
+
+    private:
+        struct record_t {
+            library_ptr_t                       owner;      // keeps the library loaded while it is in use or idle
+            boost::weak_ptr<shared_library>     in_use;     // handle that was given to users
+            std::size_t                         mapped_bytes;
+            bool                                idle;
+            std::list<key_t>::iterator          lru_pos;
+        };
+
+        typedef std::map<key_t, record_t> records_t;
+
+        mutable std::mutex  mutex_;
+        records_t           records_;
+        std::list<key_t>    lru_;       // idle libraries, most recently released first
+        std::size_t         idle_bytes_;
+        std::size_t         max_idle_count_;
+        std::size_t         max_idle_bytes_;
+
+        std::size_t         hits_;
+        std::size_t         misses_;
+        std::size_t         evictions_;
+
+        class releaser {
+            boost::weak_ptr<library_pool_state> state_;
+            key_t                               key_;
+            library_ptr_t                       owner_;
+
+        public:
+            releaser(const boost::shared_ptr<library_pool_state>& state, const key_t& key, const library_ptr_t& owner)
+                : state_(state)
+                , key_(key)
+                , owner_(owner)
+            {}
+
+            void operator()(boost::dll::shared_library* /*lib*/) {
+                const boost::shared_ptr<library_pool_state> state = state_.lock();
+                if (state) {
+                    state->release(key_, owner_);
+                }
+
+                // Library is unloaded here if it was evicted or if the pool was destroyed
+                owner_.reset();
+            }
+        };
+
+        void release(const key_t& key, const library_ptr_t& owner) BOOST_NOEXCEPT {
+            std::vector<library_ptr_t> evicted;
+
+            std::unique_lock<std::mutex> lock(mutex_);
+            records_t::iterator it = records_.find(key);
+            if (it == records_.end() || it->second.owner != owner || !it->second.in_use.expired() || it->second.idle) {
+                // Other thread took a new handle to the library before we have acquired the lock
+                return;
+            }
+
+            try {
+                lru_.push_front(key);
+            } catch (...) {
+                // No memory for keeping the library in the pool. Unloading it under the lock.
+                records_.erase(it);
+                ++evictions_;
+                return;
+            }
+            it->second.idle = true;
+            it->second.lru_pos = lru_.begin();
+            idle_bytes_ += it->second.mapped_bytes;
+
+            trim(evicted, max_idle_count_, max_idle_bytes_);
+            lock.unlock();
+            // `evicted` are unloaded here, outside of the lock
+        }
+
+        // Must be called with `mutex_` locked.
+        void trim(std::vector<library_ptr_t>& evicted, std::size_t max_count, std::size_t max_bytes) BOOST_NOEXCEPT {
+            while (!lru_.empty() && (lru_.size() > max_count || (max_bytes && idle_bytes_ > max_bytes))) {
+                records_t::iterator it = records_.find(lru_.back());
+                lru_.pop_back();
+
+                idle_bytes_ -= it->second.mapped_bytes;
+                try {
+                    evicted.push_back(it->second.owner);
+                } catch (...) {
+                    // Not enough memory to postpone the unload. Unloading under the lock.
+                }
+                records_.erase(it);
+                ++evictions_;
+            }
+        }
+
+        library_ptr_t make_handle(const boost::shared_ptr<library_pool_state>& self, const key_t& key, record_t& record) {
+            if (record.idle) {
+                lru_.erase(record.lru_pos);
+                idle_bytes_ -= record.mapped_bytes;
+                record.idle = false;
+            }
+
+            library_ptr_t handle(record.owner.get(), releaser(self, key, record.owner));
+            record.in_use = handle;
+            return handle;
+        }
+
+    public:
+        library_pool_state(std::size_t max_idle_count, std::size_t max_idle_bytes) BOOST_NOEXCEPT
+            : idle_bytes_(0)
+            , max_idle_count_(max_idle_count)
+            , max_idle_bytes_(max_idle_bytes)
+            , hits_(0)
+            , misses_(0)
+            , evictions_(0)
+        {}
+
+        static library_ptr_t load(const boost::shared_ptr<library_pool_state>& self, const key_t& key, boost::dll::fs::error_code& ec) {
+            {
+                std::lock_guard<std::mutex> lock(self->mutex_);
+                records_t::iterator it = self->records_.find(key);
+                if (it != self->records_.end()) {
+                    ++self->hits_;
+                    library_ptr_t handle = it->second.in_use.lock();
+                    return handle ? handle : self->make_handle(self, key, it->second);
+                }
+                ++self->misses_;
+            }
+
+            // Loading without holding the lock: library constructors may use the pool.
+            library_ptr_t lib = boost::make_shared<boost::dll::shared_library>();
+            lib->load(key.first, key.second, ec);
+            if (ec) {
+                return library_ptr_t();
+            }
+
+            boost::dll::fs::error_code size_ec;
+            const std::size_t mapped_bytes = boost::dll::detail::mapped_size(lib->native(), size_ec);
+
+            std::lock_guard<std::mutex> lock(self->mutex_);
+            std::pair<records_t::iterator, bool> res = self->records_.insert(
+                std::make_pair(key, record_t())
+            );
+            if (res.second) {
+                res.first->second.owner = std::move(lib);
+                res.first->second.mapped_bytes = size_ec ? 0 : mapped_bytes;
+                res.first->second.idle = false;
+            }
+
+            // If other thread has already inserted the library, our copy of it is released
+            library_ptr_t handle = res.first->second.in_use.lock();
+            return handle ? handle : self->make_handle(self, key, res.first->second);
+        }
+
+        void shrink(std::size_t max_count, std::size_t max_bytes) BOOST_NOEXCEPT {
+            std::vector<library_ptr_t> evicted;
+
+            std::unique_lock<std::mutex> lock(mutex_);
+            trim(evicted, max_count, max_bytes);
+            lock.unlock();
+        }
+
+        void set_limits(std::size_t max_count, std::size_t max_bytes) BOOST_NOEXCEPT {
+            std::vector<library_ptr_t> evicted;
+
+            std::unique_lock<std::mutex> lock(mutex_);
+            max_idle_count_ = max_count;
+            max_idle_bytes_ = max_bytes;
+            trim(evicted, max_count, max_bytes);
+            lock.unlock();
+        }
+
+        std::size_t max_idle_count() const BOOST_NOEXCEPT {
+            std::lock_guard<std::mutex> lock(mutex_);
+            return max_idle_count_;
+        }
+
+        std::size_t max_idle_bytes() const BOOST_NOEXCEPT {
+            std::lock_guard<std::mutex> lock(mutex_);
+            return max_idle_bytes_;
+        }
+
+        template <class Statistics>
+        void fill(Statistics& s) const BOOST_NOEXCEPT {
+            std::lock_guard<std::mutex> lock(mutex_);
+            s.hits = hits_;
+            s.misses = misses_;
+            s.evictions = evictions_;
+            s.loaded_count = records_.size();
+            s.idle_count = lru_.size();
+            s.idle_bytes = idle_bytes_;
+        }
+    };
+
+} // namespace detail
+/// @endcond
+
+
+/*!
+* \brief Keeps recently released libraries loaded, so that the next request for the
+* same library does not call the OS loader.
+*
+* Libraries are keyed by the path (as it was passed to \forcedlink{library_pool}`::load`) and the
+* load mode. All the handles to the same key share a single \forcedlink{shared_library} instance.
+* When all the handles are destroyed, the library becomes idle and stays loaded until it is
+* evicted. Least recently used idle libraries are evicted when the count of idle libraries exceeds
+* `max_idle_count()` or when the summary mapped size of idle libraries exceeds `max_idle_bytes()`.
+*
+* Handles stay valid after the destruction of the pool. Idle libraries are released by the destructor.
+*
+* All the member functions are thread safe.
+*/
+class library_pool: private boost::noncopyable {
+    boost::shared_ptr<boost::dll::detail::library_pool_state> state_;
+
+public:
+    /// Counters of the pool. Returned by \forcedlink{library_pool}`::statistics()`.
+    struct statistics_t {
+        std::size_t hits;           ///< Count of requests that were served without loading a library.
+        std::size_t misses;         ///< Count of requests that required loading a library.
+        std::size_t evictions;      ///< Count of idle libraries released by the pool.
+        std::size_t loaded_count;   ///< Count of libraries that are currently in use or idle.
+        std::size_t idle_count;     ///< Count of libraries that are loaded but have no handles.
+        std::size_t idle_bytes;     ///< Summary mapped size of idle libraries. Zero on platforms where mapped size is unknown.
+    };
+
+    /*!
+    * Creates an empty pool.
+    *
+    * \param max_idle_count Maximal count of idle libraries to keep loaded.
+    * \param max_idle_bytes Maximal summary mapped size of idle libraries to keep loaded. 0 means no limit.
+    * \throw std::bad_alloc in case of insufficient memory.
+    */
+    explicit library_pool(std::size_t max_idle_count, std::size_t max_idle_bytes = 0)
+        : state_(boost::make_shared<boost::dll::detail::library_pool_state>(max_idle_count, max_idle_bytes))
+    {}
+
+    /*!
+    * Releases all the idle libraries. Libraries that have handles stay loaded until the handles are destroyed.
+    *
+    * \throw Nothing.
+    */
+    ~library_pool() BOOST_NOEXCEPT {
+        clear();
+    }
+
+    /*!
+    * Returns a handle to the library with the specified path and mode. Loads the library if it is not in the pool.
+    *
+    * \param lib_path Library file name. Can handle std::string, const char*, std::wstring,
+    *           const wchar_t* or \forcedlinkfs{path}.
+    * \param mode A mode that will be used on library load.
+    * \return Shared pointer to the library. All the copies of the pointer reference the same library instance.
+    * \throw \forcedlinkfs{system_error}, std::bad_alloc in case of insufficient memory.
+    */
+    boost::shared_ptr<shared_library> load(const boost::dll::fs::path& lib_path, load_mode::type mode = load_mode::default_mode) {
+        boost::dll::fs::error_code ec;
+        boost::shared_ptr<shared_library> lib = load(lib_path, mode, ec);
+
+        if (ec) {
+            boost::dll::detail::report_error(ec, "boost::dll::library_pool::load() failed");
+        }
+
+        return lib;
+    }
+
+    /*!
+    * Returns a handle to the library with the specified path and mode. Loads the library if it is not in the pool.
+    *
+    * \param lib_path Library file name. Can handle std::string, const char*, std::wstring,
+    *           const wchar_t* or \forcedlinkfs{path}.
+    * \param ec Variable that will be set to the result of the operation.
+    * \param mode A mode that will be used on library load.
+    * \return Shared pointer to the library or empty pointer in case of error.
+    * \throw std::bad_alloc in case of insufficient memory.
+    */
+    boost::shared_ptr<shared_library> load(const boost::dll::fs::path& lib_path, boost::dll::fs::error_code& ec, load_mode::type mode = load_mode::default_mode) {
+        return load(lib_path, mode, ec);
+    }
+
+    //! \overload boost::shared_ptr<shared_library> load(const boost::dll::fs::path& lib_path, boost::dll::fs::error_code& ec, load_mode::type mode = load_mode::default_mode)
+    boost::shared_ptr<shared_library> load(const boost::dll::fs::path& lib_path, load_mode::type mode, boost::dll::fs::error_code& ec) {
+        ec.clear();
+        return boost::dll::detail::library_pool_state::load(state_, std::make_pair(lib_path, mode), ec);
+    }
+
+    /*!
+    * Releases all the idle libraries.
+    *
+    * \post `statistics().idle_count == 0`
+    * \throw Nothing.
+    */
+    void clear() BOOST_NOEXCEPT {
+        state_->shrink(0, 0);
+    }
+
+    /*!
+    * Changes the limits and evicts idle libraries that do not fit into them.
+    *
+    * \param max_idle_count Maximal count of idle libraries to keep loaded.
+    * \param max_idle_bytes Maximal summary mapped size of idle libraries to keep loaded. 0 means no limit.
+    * \throw Nothing.
+    */
+    void set_limits(std::size_t max_idle_count, std::size_t max_idle_bytes = 0) BOOST_NOEXCEPT {
+        state_->set_limits(max_idle_count, max_idle_bytes);
+    }
+
+    /// \return Maximal count of idle libraries to keep loaded.
+    std::size_t max_idle_count() const BOOST_NOEXCEPT {
+        return state_->max_idle_count();
+    }
+
+    /// \return Maximal summary mapped size of idle libraries to keep loaded. 0 means no limit.
+    std::size_t max_idle_bytes() const BOOST_NOEXCEPT {
+        return state_->max_idle_bytes();
+    }
+
+    /*!
+    * \return Snapshot of the pool counters.
+    * \throw Nothing.
+    */
+    statistics_t statistics() const BOOST_NOEXCEPT {
+        statistics_t s;
+        state_->fill(s);
+        return s;
+    }
+};
+
+}} // boost::dll
+
+#endif // BOOST_DLL_LIBRARY_POOL_HPP
@@ -0,0 +1,175 @@
+// Copyright 2020 Antony Polukhin.
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt
+// or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BOOST_DLL_LIBRARY_STATS_HPP
+#define BOOST_DLL_LIBRARY_STATS_HPP
+
+/// \file boost/dll/library_stats.hpp
+/// \brief Contains the boost::dll::stats() function that reports memory and latency costs of a loaded library.
+
+#include <boost/dll/config.hpp>
+#include <boost/dll/shared_library.hpp>
+#include <boost/predef/os.h>
+
+#ifdef BOOST_NO_CXX11_HDR_CHRONO
+#  error This file requires C++11 at least!
+#endif
+
+#include <chrono>
+#include <vector>
+
+#if BOOST_OS_WINDOWS
+#   include <boost/dll/detail/windows/mapped_regions.hpp>
+#else
+#   include <boost/dll/detail/posix/mapped_regions.hpp>
+#endif
+
+#ifdef BOOST_DLL_ENABLE_TRACING
+#   include <boost/dll/detail/lifecycle_trace.hpp>
+#endif
+
+#ifdef BOOST_HAS_PRAGMA_ONCE
+# pragma once
+#endif
+
+namespace boost { namespace dll {
+
+/*!
+* \brief Runtime statistics of a loaded library returned by boost::dll::stats().
+*/
+struct library_stats {
+    /// Address range of a loaded segment of the library.
+    struct region {
+        const void*     begin;
+        std::size_t     size;
+    };
+
+    /// Loaded segments of the library. Whole image on Windows.
+    std::vector<region>         regions;
+
+    /// Sum of the sizes of all the `regions`.
+    std::size_t                 mapped_bytes;
+
+    /// Bytes of the library that are in RAM. Zero if the platform does not provide such information.
+    std::size_t                 resident_bytes;
+
+    /// Bytes of the library that were modified after load. Zero if the platform does not provide such information.
+    std::size_t                 dirty_bytes;
+
+    /// Duration of the `shared_library::load` that mapped the library into the process.
+    /// Zero if \forcedmacrolink{BOOST_DLL_ENABLE_TRACING} is not defined or if the library was loaded
+    /// while the collection was disabled, see boost::dll::set_stats_collection().
+    std::chrono::nanoseconds    load_duration;
+
+    /// Count of the successful symbol lookups via `shared_library::get*` and `shared_library::has`
+    /// functions since the library was mapped. Zero if \forcedmacrolink{BOOST_DLL_ENABLE_TRACING} is not defined
+    /// or if the library was loaded while the collection was disabled, see boost::dll::set_stats_collection().
+    std::size_t                 resolved_symbols;
+
+    library_stats() BOOST_NOEXCEPT
+        : mapped_bytes(0)
+        , resident_bytes(0)
+        , dirty_bytes(0)
+        , load_duration(0)
+        , resolved_symbols(0)
+    {}
+};
+
+/*!
+* Enables or disables tracking of the load durations and of the resolved symbols counts reported by
+* boost::dll::stats(). Tracking is disabled by default, so that symbol lookups do not take the lock of the
+* statistics registry. Loads and unloads are counted anyway, so the tracking could be toggled while libraries
+* are loaded. Does nothing if \forcedmacrolink{BOOST_DLL_ENABLE_TRACING} is not defined.
+*
+* Libraries that were loaded while the tracking was disabled have zero load duration and resolved symbols count.
+*
+* \param enable true to enable the tracking.
+* \return Previous state of the tracking.
+* \throw Nothing.
+*/
+inline bool set_stats_collection(bool enable) BOOST_NOEXCEPT {
+#ifdef BOOST_DLL_ENABLE_TRACING
+    return boost::dll::detail::stats_collection_flag().exchange(enable);
+#else
+    (void)enable;
+    return false;
+#endif
+}
+
+/*!
+* Collects runtime statistics of a loaded library.
+*
+* On Linux resident and dirty sizes are taken from `/proc/self/smaps`, on FreeBSD they
+* are computed using `mincore`. Parsing `/proc/self/smaps` takes time proportional
+* to the count of mappings in the process, so do not call this function on hot paths.
+*
+* Load duration and resolved symbols count are tracked only if \forcedmacrolink{BOOST_DLL_ENABLE_TRACING}
+* is defined and the collection was enabled by boost::dll::set_stats_collection() before the library was loaded,
+* and only for the libraries loaded and queried by the binary that calls this function.
+*
+* \param lib Loaded library.
+* \param ec Variable that will be set to the result of the operation.
+* \return Statistics of the library.
+* \throw std::bad_alloc in case of insufficient memory.
+*/
+inline library_stats stats(const shared_library& lib, boost::dll::fs::error_code& ec) {
+    library_stats ret;
+    ec.clear();
+    if (!lib) {
+        ec = boost::dll::fs::make_error_code(
+            boost::dll::fs::errc::bad_file_descriptor
+        );
+
+        return ret;
+    }
+
+    std::vector<boost::dll::detail::mapped_region> regions;
+    boost::dll::detail::mapped_regions(lib.native(), regions, ec);
+    if (ec) {
+        return ret;
+    }
+
+    ret.regions.reserve(regions.size());
+    for (std::size_t i = 0; i < regions.size(); ++i) {
+        const library_stats::region r = { regions[i].begin, regions[i].size };
+        ret.regions.push_back(r);
+        ret.mapped_bytes += r.size;
+    }
+
+    boost::dll::detail::resident_size(regions, ret.resident_bytes, ret.dirty_bytes);
+
+#ifdef BOOST_DLL_ENABLE_TRACING
+    boost::dll::detail::trace_registry_entry entry;
+    if (boost::dll::detail::trace_registry::instance().find(lib.native(), entry)) {
+        ret.load_duration = std::chrono::duration_cast<std::chrono::nanoseconds>(entry.load_duration);
+        ret.resolved_symbols = entry.resolved_symbols;
+    }
+#endif
+
+    return ret;
+}
+
+/*!
+* Collects runtime statistics of a loaded library.
+*
+* \param lib Loaded library.
+* \return Statistics of the library.
+* \throw \forcedlinkfs{system_error} if the library is not loaded or the platform
+* does not allow to get the loaded segments, std::bad_alloc in case of insufficient memory.
+*/
+inline library_stats stats(const shared_library& lib) {
+    boost::dll::fs::error_code ec;
+    library_stats ret = boost::dll::stats(lib, ec);
+    if (ec) {
+        boost::dll::detail::report_error(ec, "boost::dll::stats() failed");
+    }
+
+    return ret;
+}
+
+}} // boost::dll
+
+#endif // BOOST_DLL_LIBRARY_STATS_HPP
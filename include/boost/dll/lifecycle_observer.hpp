@@ -0,0 +1,245 @@
+// Copyright 2020 Antony Polukhin.
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt
+// or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BOOST_DLL_LIFECYCLE_OBSERVER_HPP
+#define BOOST_DLL_LIFECYCLE_OBSERVER_HPP
+
+/// \file boost/dll/lifecycle_observer.hpp
+/// \brief Contains the boost::dll::lifecycle_observer interface for tracing library loads, unloads
+/// and symbol lookups, and the boost::dll::chrome_trace_observer that writes the events in
+/// Chrome trace event format.
+
+#include <boost/dll/config.hpp>
+#include <boost/dll/shared_library_load_mode.hpp>
+#include <boost/noncopyable.hpp>
+#include <boost/predef/os.h>
+
+#if defined(BOOST_NO_CXX11_HDR_CHRONO) || defined(BOOST_NO_CXX11_HDR_ATOMIC) || defined(BOOST_NO_CXX11_HDR_MUTEX) || defined(BOOST_NO_CXX11_HDR_THREAD)
+#  error This file requires C++11 at least!
+#endif
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>   // std::snprintf
+#include <functional>   // std::hash
+#include <mutex>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <thread>
+
+#if BOOST_OS_WINDOWS
+#   include <boost/winapi/get_current_process_id.hpp>
+#else
+#   include <unistd.h>  // getpid
+#endif
+
+#ifdef BOOST_HAS_PRAGMA_ONCE
+# pragma once
+#endif
+
+namespace boost { namespace dll {
+
+/*!
+* \brief Interface for receiving notifications about library loads, unloads, symbol lookups and
+* smart_library symbol storage builds.
+*
+* Notifications are issued only if the \forcedmacrolink{BOOST_DLL_ENABLE_TRACING} macro is defined.
+* Without that macro the notification code is not compiled at all.
+*
+* Member functions could be called concurrently from different threads. Exceptions thrown
+* from the member functions are ignored.
+*/
+class lifecycle_observer {
+public:
+    /// Clock that is used for all the timestamps and durations.
+    typedef std::chrono::steady_clock clock_type;
+
+    /// Called before the `shared_library::load`.
+    virtual void on_load_begin(const boost::dll::fs::path& /*lib_path*/, load_mode::type /*mode*/, clock_type::time_point /*start*/) {}
+
+    /// Called after the `shared_library::load`. `ec` holds the result of the load.
+    virtual void on_load_end(const boost::dll::fs::path& /*lib_path*/, load_mode::type /*mode*/, const boost::dll::fs::error_code& /*ec*/,
+        clock_type::time_point /*start*/, clock_type::duration /*duration*/) {}
+
+    /// Called after the library was unloaded by the `shared_library::unload` or by `shared_library` destructor.
+    virtual void on_unload(const boost::dll::fs::path& /*lib_path*/, clock_type::time_point /*start*/, clock_type::duration /*duration*/) {}
+
+    /// Called after the symbol lookup by `shared_library::get*` or `shared_library::has` functions.
+    virtual void on_symbol(const boost::dll::fs::path& /*lib_path*/, const char* /*symbol_name*/, bool /*found*/,
+        clock_type::time_point /*start*/, clock_type::duration /*duration*/) {}
+
+    /// Called after the symbol storage of the `experimental::smart_library` was built.
+    virtual void on_storage_build(const boost::dll::fs::path& /*lib_path*/, std::size_t /*symbols_count*/,
+        clock_type::time_point /*start*/, clock_type::duration /*duration*/) {}
+
+    virtual ~lifecycle_observer() {}
+};
+
+/// @cond
+namespace detail {
+    inline std::atomic<boost::dll::lifecycle_observer*>& lifecycle_observer_storage() BOOST_NOEXCEPT {
+        static std::atomic<boost::dll::lifecycle_observer*> observer(nullptr);
+        return observer;
+    }
+} // namespace detail
+/// @endcond
+
+/*!
+* Installs the observer for the current binary (each executable or shared library that uses Boost.DLL has its own observer).
+*
+* \param observer Observer to install or nullptr to stop tracing. Must outlive all the operations that may report to it.
+* \return Previously installed observer or nullptr.
+* \throw Nothing.
+*/
+inline lifecycle_observer* set_lifecycle_observer(lifecycle_observer* observer) BOOST_NOEXCEPT {
+    return boost::dll::detail::lifecycle_observer_storage().exchange(observer);
+}
+
+/*!
+* \return Currently installed observer or nullptr.
+* \throw Nothing.
+*/
+inline lifecycle_observer* get_lifecycle_observer() BOOST_NOEXCEPT {
+    return boost::dll::detail::lifecycle_observer_storage().load(std::memory_order_acquire);
+}
+
+
+/*!
+* \brief Observer that writes the events in Chrome trace event JSON format, suitable for
+* chrome://tracing and https://ui.perfetto.dev.
+*
+* Timestamps are in microseconds since the construction of the observer. The closing part of the
+* JSON is written by the destructor.
+*
+* \b Example:
+* \code
+* std::ofstream f("plugins_trace.json");
+* boost::dll::chrome_trace_observer tracer(f);
+* boost::dll::set_lifecycle_observer(&tracer);
+*
+* boost::dll::shared_library lib("libmy_plugin.so");
+* // ...
+* boost::dll::set_lifecycle_observer(nullptr);
+* \endcode
+*/
+class chrome_trace_observer: public lifecycle_observer, private boost::noncopyable {
+    std::mutex                  mutex_;
+    std::ostream&               out_;
+    const clock_type::time_point epoch_;
+    bool                        first_event_;
+
+    static void write_escaped(std::ostream& out, const std::string& s) {
+        for (std::size_t i = 0; i < s.size(); ++i) {
+            const unsigned char c = static_cast<unsigned char>(s[i]);
+            switch (c) {
+            case '"':  out << "\\\""; break;
+            case '\\': out << "\\\\"; break;
+            case '\n': out << "\\n"; break;
+            case '\r': out << "\\r"; break;
+            case '\t': out << "\\t"; break;
+            default:
+                if (c < 0x20) {
+                    char buf[8];
+                    std::snprintf(buf, sizeof(buf), "\\u%04x", static_cast<unsigned>(c));
+                    out << buf;
+                } else {
+                    out << s[i];
+                }
+            }
+        }
+    }
+
+    static unsigned long process_id() BOOST_NOEXCEPT {
+#if BOOST_OS_WINDOWS
+        return boost::winapi::GetCurrentProcessId();
+#else
+        return static_cast<unsigned long>(::getpid());
+#endif
+    }
+
+    double microseconds(clock_type::duration d) const {
+        return std::chrono::duration_cast<std::chrono::duration<double, std::micro> >(d).count();
+    }
+
+    void write_event(const char* name, clock_type::time_point start, clock_type::duration duration,
+        const boost::dll::fs::path& lib_path, const char* extra_args)
+    {
+        char timings[96];
+        std::snprintf(timings, sizeof(timings), "\"ts\":%.3f,\"dur\":%.3f",
+            microseconds(start - epoch_), microseconds(duration));
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        out_ << (first_event_ ? "\n" : ",\n");
+        first_event_ = false;
+
+        out_ << "{\"name\":\"" << name << "\",\"cat\":\"boost.dll\",\"ph\":\"X\"," << timings
+            << ",\"pid\":" << process_id()
+            << ",\"tid\":" << std::hash<std::thread::id>()(std::this_thread::get_id())
+            << ",\"args\":{\"path\":\"";
+        write_escaped(out_, lib_path.string());
+        out_ << '"' << extra_args << "}}";
+    }
+
+public:
+    /*!
+    * Writes the opening part of the JSON into `out`.
+    *
+    * \param out Stream for the trace. Must outlive the observer.
+    */
+    explicit chrome_trace_observer(std::ostream& out)
+        : out_(out)
+        , epoch_(clock_type::now())
+        , first_event_(true)
+    {
+        out_ << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    }
+
+    /// Writes the closing part of the JSON and flushes the stream.
+    ~chrome_trace_observer() {
+        out_ << "\n]}\n";
+        out_.flush();
+    }
+
+    void on_load_end(const boost::dll::fs::path& lib_path, load_mode::type mode, const boost::dll::fs::error_code& ec,
+        clock_type::time_point start, clock_type::duration duration) BOOST_OVERRIDE
+    {
+        std::string args = ",\"mode\":" + std::to_string(static_cast<long long>(mode));
+        if (ec) {
+            std::ostringstream error;
+            error << ",\"error\":\"";
+            write_escaped(error, ec.message());
+            error << '"';
+            args += error.str();
+        }
+        write_event("load", start, duration, lib_path, args.c_str());
+    }
+
+    void on_unload(const boost::dll::fs::path& lib_path, clock_type::time_point start, clock_type::duration duration) BOOST_OVERRIDE {
+        write_event("unload", start, duration, lib_path, "");
+    }
+
+    void on_symbol(const boost::dll::fs::path& lib_path, const char* symbol_name, bool found,
+        clock_type::time_point start, clock_type::duration duration) BOOST_OVERRIDE
+    {
+        std::ostringstream args;
+        args << ",\"symbol\":\"";
+        write_escaped(args, symbol_name);
+        args << "\",\"found\":" << (found ? "true" : "false");
+        write_event("symbol", start, duration, lib_path, args.str().c_str());
+    }
+
+    void on_storage_build(const boost::dll::fs::path& lib_path, std::size_t symbols_count,
+        clock_type::time_point start, clock_type::duration duration) BOOST_OVERRIDE
+    {
+        const std::string args = ",\"symbols\":" + std::to_string(static_cast<unsigned long long>(symbols_count));
+        write_event("storage_build", start, duration, lib_path, args.c_str());
+    }
+};
+
+}} // boost::dll
+
+#endif // BOOST_DLL_LIFECYCLE_OBSERVER_HPP
@@ -0,0 +1,160 @@
+// Copyright 2020 Antony Polukhin.
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt
+// or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BOOST_DLL_MANIFEST_HPP
+#define BOOST_DLL_MANIFEST_HPP
+
+/// \file boost/dll/manifest.hpp
+/// \brief Contains the BOOST_DLL_MANIFEST macro and the boost::dll::plugin_manifest structure, that
+/// could be read by boost::dll::library_info::manifest() without loading the binary.
+
+#include <boost/dll/config.hpp>
+#include <boost/dll/alias.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/predef/os.h>
+#include <boost/static_assert.hpp>
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+#ifdef BOOST_HAS_PRAGMA_ONCE
+# pragma once
+#endif
+
+namespace boost { namespace dll {
+
+/// @cond
+namespace detail {
+
+    // Layout of this structure is a part of the ABI, new fields could be only appended.
+    struct manifest_record {
+        boost::uint32_t magic;
+        boost::uint32_t record_size;
+        boost::uint32_t abi_version;
+        boost::uint32_t version_major;
+        boost::uint32_t version_minor;
+        boost::uint32_t version_patch;
+        char            name[64];
+    };
+
+    BOOST_STATIC_CONSTANT(boost::uint32_t, manifest_magic = 0x4d4c4442u); // "BDLM"
+
+} // namespace detail
+/// @endcond
+
+/*!
+* \brief Metadata of a binary written by \forcedmacrolink{BOOST_DLL_MANIFEST}.
+*/
+struct plugin_manifest {
+    /// Name of the plugin.
+    std::string     name;
+
+    /// ABI version of the plugin interface.
+    unsigned        abi_version;
+
+    /// Version of the plugin.
+    unsigned        version_major;
+    unsigned        version_minor;
+    unsigned        version_patch;
+};
+
+/// @cond
+namespace detail {
+
+    inline bool parse_manifest(const std::vector<char>& data, boost::dll::plugin_manifest& ret) {
+        boost::dll::detail::manifest_record record;
+        if (data.size() < sizeof(record)) {
+            return false;
+        }
+
+        std::memcpy(&record, &data[0], sizeof(record));
+        if (record.magic != boost::dll::detail::manifest_magic || record.record_size < sizeof(record)) {
+            return false;
+        }
+
+        record.name[sizeof(record.name) - 1] = '\0';
+        ret.name = record.name;
+        ret.abi_version = record.abi_version;
+        ret.version_major = record.version_major;
+        ret.version_minor = record.version_minor;
+        ret.version_patch = record.version_patch;
+        return true;
+    }
+
+} // namespace detail
+
+#if BOOST_OS_WINDOWS
+// GetProcAddress looks only into the module itself, so the export does not clash with other modules.
+// The export keeps the record from being removed by the linker.
+#   define BOOST_DLL_DETAIL_MANIFEST_LINKAGE BOOST_SYMBOL_EXPORT
+#   define BOOST_DLL_DETAIL_MANIFEST_KEEP
+#else
+// Every binary defines a symbol with the same name, so the record is hidden and is read only from the section.
+// Otherwise the dynamic linker could resolve the name to the record of another module.
+// `retain` keeps the unreferenced record with --gc-sections, where the compiler supports it.
+#   if defined(__has_attribute)
+#       if __has_attribute(retain)
+#           define BOOST_DLL_DETAIL_MANIFEST_RETAIN retain,
+#       endif
+#   endif
+#   ifndef BOOST_DLL_DETAIL_MANIFEST_RETAIN
+#       define BOOST_DLL_DETAIL_MANIFEST_RETAIN
+#   endif
+#   define BOOST_DLL_DETAIL_MANIFEST_LINKAGE __attribute__((visibility("hidden")))
+#   define BOOST_DLL_DETAIL_MANIFEST_KEEP __attribute__((BOOST_DLL_DETAIL_MANIFEST_RETAIN used))
+#endif
+/// @endcond
+
+/*!
+* \brief Writes a fixed layout metadata record into the `boostmnf` section of the binary.
+*
+* The record could be read by boost::dll::library_info::manifest() directly from the file, without loading
+* the binary and running its static constructors. Only one manifest is allowed per binary. The record is not
+* exported, except on Windows, so it could not be imported with boost::dll::shared_library::get().
+*
+* \param Name String literal with the name of the plugin, at most 63 characters.
+* \param VersionMajor Major version of the plugin.
+* \param VersionMinor Minor version of the plugin.
+* \param VersionPatch Patch version of the plugin.
+* \param AbiVersion Version of the interface that the plugin implements.
+*
+* \b Example:
+* \code
+* BOOST_DLL_MANIFEST("my_plugin", 1, 4, 0, 2)
+*
+* // Scanner:
+* boost::dll::library_info info("libmy_plugin.so");
+* boost::optional<boost::dll::plugin_manifest> m = info.manifest();
+* if (m && m->abi_version == 2) {
+*     // Compatible, load it
+* }
+* \endcode
+*/
+#define BOOST_DLL_MANIFEST(Name, VersionMajor, VersionMinor, VersionPatch, AbiVersion)      \
+    BOOST_STATIC_ASSERT_MSG(                                                                \
+        sizeof(Name) <= sizeof(boost::dll::detail::manifest_record().name),                 \
+        "Name of the plugin in BOOST_DLL_MANIFEST must be at most 63 characters long"       \
+    );                                                                                      \
+    namespace _autoaliases {                                                                \
+        extern "C" BOOST_DLL_DETAIL_MANIFEST_LINKAGE                                        \
+            const boost::dll::detail::manifest_record boost_dll_manifest;                   \
+        BOOST_DLL_SECTION(boostmnf, read) BOOST_DLL_DETAIL_MANIFEST_KEEP                    \
+            const boost::dll::detail::manifest_record                                       \
+            boost_dll_manifest = {                                                          \
+                boost::dll::detail::manifest_magic,                                         \
+                sizeof(boost::dll::detail::manifest_record),                                \
+                AbiVersion,                                                                 \
+                VersionMajor,                                                               \
+                VersionMinor,                                                               \
+                VersionPatch,                                                               \
+                Name                                                                        \
+            };                                                                              \
+    } /**/
+
+}} // boost::dll
+
+#endif // BOOST_DLL_MANIFEST_HPP
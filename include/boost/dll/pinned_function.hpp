@@ -0,0 +1,275 @@
+// Copyright 2020 Antony Polukhin.
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt
+// or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BOOST_DLL_PINNED_FUNCTION_HPP
+#define BOOST_DLL_PINNED_FUNCTION_HPP
+
+/// \file boost/dll/pinned_function.hpp
+/// \brief Contains the boost::dll::library_scope guard and the boost::dll::pinned_function
+/// callable that is as small as a raw function pointer.
+
+#include <boost/dll/config.hpp>
+#include <boost/dll/shared_library.hpp>
+#include <boost/assert.hpp>
+#include <boost/core/explicit_operator_bool.hpp>
+#include <boost/move/move.hpp>
+#include <boost/static_assert.hpp>
+#include <boost/type_traits/is_function.hpp>
+
+#ifdef BOOST_DLL_DEBUG_PINNED_FUNCTIONS
+#   include <boost/make_shared.hpp>
+#   include <boost/shared_ptr.hpp>
+#   include <boost/weak_ptr.hpp>
+#endif
+
+#ifdef BOOST_HAS_PRAGMA_ONCE
+# pragma once
+#endif
+
+#ifdef BOOST_DLL_DOXYGEN
+/// Define this macro to make each boost::dll::pinned_function remember its boost::dll::library_scope
+/// and assert on calls after the scope was destroyed. Increases the size of boost::dll::pinned_function.
+#define BOOST_DLL_DEBUG_PINNED_FUNCTIONS BOOST_DLL_DEBUG_PINNED_FUNCTIONS
+#endif
+
+namespace boost { namespace dll {
+
+/// @cond
+namespace detail {
+    struct library_scope_marker {};
+} // namespace detail
+/// @endcond
+
+template <class Sig>
+class pinned_function;
+
+/*!
+* \brief Keeps the library loaded while the boost::dll::pinned_function instances that were
+* obtained from it are in use.
+*
+* Unlike boost::dll::import, functions obtained from library_scope do not refcount the library.
+* User is responsible for keeping the library_scope alive while the functions are called.
+*
+* \b Example:
+* \code
+* boost::dll::library_scope plugin("libmy_plugin.so");
+* std::vector<boost::dll::pinned_function<int(int)> > routes;
+* routes.push_back(plugin.get<int(int)>("route_a"));
+* routes.push_back(plugin.get<int(int)>("route_b"));
+* // ... `plugin` must outlive `routes`
+* \endcode
+*/
+class library_scope {
+    BOOST_MOVABLE_BUT_NOT_COPYABLE(library_scope)
+
+    boost::dll::shared_library lib_;
+#ifdef BOOST_DLL_DEBUG_PINNED_FUNCTIONS
+    boost::shared_ptr<boost::dll::detail::library_scope_marker> marker_;
+#endif
+
+    template <class Sig>
+    pinned_function<Sig> make_pinned(Sig* f) const BOOST_NOEXCEPT {
+#ifdef BOOST_DLL_DEBUG_PINNED_FUNCTIONS
+        return pinned_function<Sig>(f, marker_);
+#else
+        return pinned_function<Sig>(f);
+#endif
+    }
+
+    void init_marker() {
+#ifdef BOOST_DLL_DEBUG_PINNED_FUNCTIONS
+        marker_ = boost::make_shared<boost::dll::detail::library_scope_marker>();
+#endif
+    }
+
+public:
+    /*!
+    * Loads a library by specified path with a specified mode.
+    *
+    * \param lib_path Library file name. Can handle std::string, const char*, std::wstring,
+    *           const wchar_t* or \forcedlinkfs{path}.
+    * \param mode A mode that will be used on library load.
+    * \throw \forcedlinkfs{system_error}, std::bad_alloc in case of insufficient memory.
+    */
+    explicit library_scope(const boost::dll::fs::path& lib_path, load_mode::type mode = load_mode::default_mode)
+        : lib_(lib_path, mode)
+    {
+        init_marker();
+    }
+
+    /*!
+    * Shares the library with `lib`.
+    *
+    * \param lib A library to copy.
+    * \throw \forcedlinkfs{system_error}, std::bad_alloc in case of insufficient memory.
+    */
+    explicit library_scope(const boost::dll::shared_library& lib)
+        : lib_(lib)
+    {
+        init_marker();
+    }
+
+    /*!
+    * Takes the library from `lib`.
+    *
+    * \param lib A library to move from.
+    * \throw std::bad_alloc in case of insufficient memory.
+    */
+    explicit library_scope(BOOST_RV_REF(boost::dll::shared_library) lib)
+        : lib_(boost::move(lib))
+    {
+        init_marker();
+    }
+
+    /*!
+    * Move constructor. Functions obtained from `scope` remain valid.
+    *
+    * \throw Nothing.
+    */
+    library_scope(BOOST_RV_REF(library_scope) scope) BOOST_NOEXCEPT
+        : lib_(boost::move(scope.lib_))
+#ifdef BOOST_DLL_DEBUG_PINNED_FUNCTIONS
+        , marker_(boost::move(scope.marker_))
+#endif
+    {}
+
+    /*!
+    * Move assignment. Library of *this is released, so functions obtained from *this become invalid.
+    * Functions obtained from `scope` remain valid. `scope` holds no library after the call.
+    *
+    * \throw Nothing.
+    */
+    library_scope& operator=(BOOST_RV_REF(library_scope) scope) BOOST_NOEXCEPT {
+        if (this == &scope) {
+            return *this;
+        }
+
+        // shared_library swaps on move assignment, so the previous library of *this is in `scope` now
+        lib_ = boost::move(scope.lib_);
+        scope.lib_.unload();
+#ifdef BOOST_DLL_DEBUG_PINNED_FUNCTIONS
+        marker_.swap(scope.marker_);
+        scope.marker_.reset();
+#endif
+        return *this;
+    }
+
+    /// \return Underlying library.
+    const boost::dll::shared_library& library() const BOOST_NOEXCEPT {
+        return lib_;
+    }
+
+    /*!
+    * \tparam Sig Function type of the symbol. Must be explicitly specified.
+    * \param name Null-terminated symbol name. Can handle std::string, char*, const char*.
+    * \return Function that is valid while *this is alive.
+    * \throw \forcedlinkfs{system_error} if symbol does not exist or if the DLL/DSO was not loaded.
+    */
+    template <class Sig>
+    pinned_function<Sig> get(const char* name) const {
+        BOOST_STATIC_ASSERT_MSG(boost::is_function<Sig>::value, "boost::dll::library_scope::get<Sig>() requires a function type");
+        return make_pinned<Sig>(&lib_.get<Sig>(name));
+    }
+
+    //! \overload pinned_function<Sig> get(const char* name) const
+    template <class Sig>
+    pinned_function<Sig> get(const std::string& name) const {
+        return get<Sig>(name.c_str());
+    }
+
+    /*!
+    * \tparam Sig Function type of the symbol alias. Must be explicitly specified.
+    * \param alias_name Null-terminated alias symbol name. Can handle std::string, char*, const char*.
+    * \return Function that is valid while *this is alive.
+    * \throw \forcedlinkfs{system_error} if symbol does not exist or if the DLL/DSO was not loaded.
+    */
+    template <class Sig>
+    pinned_function<Sig> get_alias(const char* alias_name) const {
+        BOOST_STATIC_ASSERT_MSG(boost::is_function<Sig>::value, "boost::dll::library_scope::get_alias<Sig>() requires a function type");
+        return make_pinned<Sig>(lib_.get<Sig*>(alias_name));
+    }
+
+    //! \overload pinned_function<Sig> get_alias(const char* alias_name) const
+    template <class Sig>
+    pinned_function<Sig> get_alias(const std::string& alias_name) const {
+        return get_alias<Sig>(alias_name.c_str());
+    }
+};
+
+
+/*!
+* \brief Callable that holds only a pointer to a function from a library kept alive by boost::dll::library_scope.
+*
+* Has the size of a function pointer and copies without touching any reference counters. Calling
+* the function after the destruction of the library_scope is undefined behavior, unless
+* \forcedmacrolink{BOOST_DLL_DEBUG_PINNED_FUNCTIONS} is defined, in which case such calls assert.
+*/
+template <class Sig>
+class pinned_function {
+    BOOST_STATIC_ASSERT_MSG(boost::is_function<Sig>::value, "boost::dll::pinned_function<Sig> requires a function type");
+
+    Sig* f_;
+#ifdef BOOST_DLL_DEBUG_PINNED_FUNCTIONS
+    boost::weak_ptr<boost::dll::detail::library_scope_marker> marker_;
+
+    void check() const {
+        BOOST_ASSERT_MSG(!f_ || !marker_.expired(), "boost::dll::pinned_function is used after its boost::dll::library_scope was destroyed");
+    }
+
+    pinned_function(Sig* f, const boost::shared_ptr<boost::dll::detail::library_scope_marker>& marker) BOOST_NOEXCEPT
+        : f_(f)
+        , marker_(marker)
+    {}
+#else
+    void check() const BOOST_NOEXCEPT {}
+
+    explicit pinned_function(Sig* f) BOOST_NOEXCEPT
+        : f_(f)
+    {}
+#endif
+
+    friend class boost::dll::library_scope;
+
+public:
+    /// Constructs an empty function.
+    pinned_function() BOOST_NOEXCEPT
+        : f_(0)
+    {}
+
+    /// \return Pointer to the function or nullptr if *this is empty.
+    Sig* get() const {
+        check();
+        return f_;
+    }
+
+    /// \return true if *this is empty.
+    bool operator!() const BOOST_NOEXCEPT {
+        return !f_;
+    }
+
+#if defined(BOOST_NO_CXX11_TRAILING_RESULT_TYPES) || defined(BOOST_NO_CXX11_DECLTYPE) || defined(BOOST_NO_CXX11_VARIADIC_TEMPLATES) || defined(BOOST_NO_CXX11_RVALUE_REFERENCES)
+    // Also works as a conversion to bool.
+    operator Sig*() const {
+        return get();
+    }
+#else
+    /// \return true if *this is not empty.
+    BOOST_EXPLICIT_OPERATOR_BOOL()
+
+    /// Calls the function.
+    template <class... Args>
+    inline auto operator()(Args&&... args) const
+        -> decltype( (*f_)(static_cast<Args&&>(args)...) )
+    {
+        check();
+        return (*f_)(static_cast<Args&&>(args)...);
+    }
+#endif
+};
+
+}} // boost::dll
+
+#endif // BOOST_DLL_PINNED_FUNCTION_HPP
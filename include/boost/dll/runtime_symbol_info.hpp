@@ -18,6 +18,11 @@
 #else
 #   include <dlfcn.h>
 #   include <boost/dll/detail/posix/program_location_impl.hpp>
+#   include <boost/dll/detail/posix/module_map.hpp>
+#endif
+
+#ifndef BOOST_NO_CXX11_HDR_MUTEX
+#   include <mutex>
 #endif
 
 #ifdef BOOST_HAS_PRAGMA_ONCE
@@ -36,9 +41,52 @@ namespace detail {
 } // namespace detail
 #endif
 
+/// @cond
+namespace detail {
+#ifndef BOOST_NO_CXX11_HDR_MUTEX
+    // Location of the executable does not change during the program run, so it is computed only once.
+    struct program_location_cache {
+        boost::dll::fs::path        location;
+        boost::dll::fs::error_code  error;
+
+        program_location_cache() {
+            location = boost::dll::detail::program_location_impl(error);
+        }
+    };
+
+    inline const program_location_cache*& program_location_cache_ptr() BOOST_NOEXCEPT {
+        static const program_location_cache* cache = 0;
+        return cache;
+    }
+
+    inline void create_program_location_cache() {
+        boost::dll::detail::program_location_cache_ptr() = new program_location_cache();
+    }
+
+    inline boost::dll::fs::path program_location_cached(boost::dll::fs::error_code& ec) {
+        // Never destroyed, to be usable from the destructors of objects with static storage duration.
+        // Not a lambda, see the comment in boost::dll::detail::module_map::instance().
+        static std::once_flag flag;
+        std::call_once(flag, &boost::dll::detail::create_program_location_cache);
+
+        const program_location_cache* const cache = boost::dll::detail::program_location_cache_ptr();
+        ec = cache->error;
+        return cache->location;
+    }
+#else
+    inline boost::dll::fs::path program_location_cached(boost::dll::fs::error_code& ec) {
+        return boost::dll::detail::program_location_impl(ec);
+    }
+#endif
+} // namespace detail
+/// @endcond
+
     /*!
     * On success returns full path and name to the binary object that holds symbol pointed by ptr_to_symbol.
     *
+    * On Linux with glibc and C++11 the lookup is a binary search in a cached map of the loaded
+    * segments. The map is rebuilt only after libraries were loaded or unloaded.
+    *
     * \param ptr_to_symbol Pointer to symbol which location is to be determined.
     * \param ec Variable that will be set to the result of the operation.
     * \return Path to the binary object that holds symbol or empty path in case error.
@@ -76,6 +124,26 @@ namespace detail {
 
         return boost::dll::detail::path_from_handle(reinterpret_cast<boost::winapi::HMODULE_>(mbi.AllocationBase), ec);
 #else
+        std::string name;
+        switch (boost::dll::detail::module_map_find(ptr, name)) {
+        case boost::dll::detail::module_map_found:
+            if (name.empty()) {
+                return boost::dll::detail::program_location_cached(ec);
+            }
+
+            ret = name;
+            return ret;
+
+        case boost::dll::detail::module_map_not_found:
+            ec = boost::dll::fs::make_error_code(
+                boost::dll::fs::errc::bad_address
+            );
+            return ret;
+
+        case boost::dll::detail::module_map_unavailable:
+            break;
+        }
+
         Dl_info info;
 
         // Some of the libc headers miss `const` in `dladdr(const void*, Dl_info*)`
@@ -83,6 +151,17 @@ namespace detail {
 
         if (res) {
             ret = info.dli_fname;
+
+            // The executable is reported by the path it was started with, that could be relative.
+            // Returning the same path as program_location() does, as the lookup above does.
+            boost::dll::fs::error_code prog_ec;
+            const boost::dll::fs::path prog = boost::dll::detail::program_location_cached(prog_ec);
+            if (!prog_ec && ret != prog && ret.filename() == prog.filename()) {
+                boost::dll::fs::error_code equivalent_ec;
+                if (boost::dll::fs::equivalent(ret, prog, equivalent_ec)) {
+                    ret = prog;
+                }
+            }
         } else {
             boost::dll::detail::reset_dlerror();
             ec = boost::dll::fs::make_error_code(
@@ -208,19 +287,21 @@ namespace detail {
     * for usage example. Flag '-rdynamic' must be used when linking the plugin into the executable
     * on Linux OS.
     *
+    * In C++11 the location is computed only once and cached.
+    *
     * \param ec Variable that will be set to the result of the operation.
     * \throws std::bad_alloc in case of insufficient memory. Overload that does not accept \forcedlinkfs{error_code} also throws \forcedlinkfs{system_error}.
     */
     inline boost::dll::fs::path program_location(boost::dll::fs::error_code& ec) {
         ec.clear();
-        return boost::dll::detail::program_location_impl(ec);
+        return boost::dll::detail::program_location_cached(ec);
     }
 
     //! \overload program_location(boost::dll::fs::error_code& ec) {
     inline boost::dll::fs::path program_location() {
         boost::dll::fs::path ret;
         boost::dll::fs::error_code ec;
-        ret = boost::dll::detail::program_location_impl(ec);
+        ret = boost::dll::detail::program_location_cached(ec);
 
         if (ec) {
             boost::dll::detail::report_error(ec, "boost::dll::program_location() failed");
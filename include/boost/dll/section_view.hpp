@@ -0,0 +1,111 @@
+// Copyright 2020 Antony Polukhin.
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt
+// or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BOOST_DLL_SECTION_VIEW_HPP
+#define BOOST_DLL_SECTION_VIEW_HPP
+
+/// \file boost/dll/section_view.hpp
+/// \brief Contains the boost::dll::section_view functions that list the aliases from a section of a loaded library.
+
+#include <boost/dll/config.hpp>
+#include <boost/dll/library_info.hpp>
+#include <boost/dll/shared_library.hpp>
+#include <boost/predef/os.h>
+#include <boost/throw_exception.hpp>
+
+#if !BOOST_OS_WINDOWS
+#   include <boost/dll/detail/posix/loaded_section.hpp>
+#endif
+
+#include <string>
+#include <vector>
+
+#ifdef BOOST_HAS_PRAGMA_ONCE
+# pragma once
+#endif
+
+namespace boost { namespace dll {
+
+/*!
+* \brief Alias from a section of the loaded library, see boost::dll::section_view().
+*/
+struct section_entry {
+    /// Name of the alias.
+    std::string name;
+
+    /// Address of the aliased function or variable. Same as `&lib.get_alias<T>(name)`.
+    void*       address;
+};
+
+/// @cond
+namespace detail {
+    inline std::vector<section_entry> section_view_from_file(const shared_library& lib, const char* section_name) {
+        const std::vector<std::string> names = boost::dll::library_info(lib.location()).symbols(section_name);
+
+        std::vector<section_entry> ret;
+        ret.reserve(names.size());
+        for (std::size_t i = 0; i < names.size(); ++i) {
+            const section_entry e = { names[i], lib.get<void*>(names[i]) };
+            ret.push_back(e);
+        }
+
+        return ret;
+    }
+} // namespace detail
+/// @endcond
+
+/*!
+* Returns the aliases that were put into the section by \forcedmacrolink{BOOST_DLL_ALIAS_SECTIONED}
+* or \forcedmacrolink{BOOST_DLL_ALIAS}. Unlike boost::dll::library_info::symbols(const char*) the file
+* is not read again on platforms with ELF binaries: the section bounds are taken from the ELF note
+* that the alias macros put into the loaded image and the names are taken from the dynamic symbol table.
+*
+* On other platforms, or if the library was built without that note, falls back to reading
+* the file with boost::dll::library_info.
+*
+* \b Example:
+* \code
+* shared_library lib("libplugins.so");
+* std::vector<section_entry> plugins = boost::dll::section_view(lib, "plugins");
+* for (std::size_t i = 0; i < plugins.size(); ++i) {
+*     std::cout << plugins[i].name << '\n';
+* }
+* \endcode
+*
+* \param lib Loaded library.
+* \param section_name Name of the section. Can handle std::string, char*, const char*.
+* \return Aliases from the section, in unspecified order.
+* \throw \forcedlinkfs{system_error} if the DLL/DSO was not loaded, std::bad_alloc in case of insufficient memory.
+*       Fallback also throws the exceptions of boost::dll::library_info.
+*/
+inline std::vector<section_entry> section_view(const shared_library& lib, const char* section_name) {
+    if (!lib.is_loaded()) {
+        boost::throw_exception(
+            boost::dll::fs::system_error(
+                boost::dll::fs::make_error_code(boost::dll::fs::errc::bad_file_descriptor),
+                "boost::dll::section_view() failed: no library was loaded"
+            )
+        );
+    }
+
+    std::vector<section_entry> ret;
+#ifdef BOOST_DLL_DETAIL_HAS_LOADED_SECTION
+    if (boost::dll::detail::loaded_section_entries(lib.native(), section_name, ret)) {
+        return ret;
+    }
+#endif
+
+    return boost::dll::detail::section_view_from_file(lib, section_name);
+}
+
+//! \overload std::vector<section_entry> section_view(const shared_library& lib, const char* section_name)
+inline std::vector<section_entry> section_view(const shared_library& lib, const std::string& section_name) {
+    return boost::dll::section_view(lib, section_name.c_str());
+}
+
+}} // boost::dll
+
+#endif // BOOST_DLL_SECTION_VIEW_HPP
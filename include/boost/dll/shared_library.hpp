@@ -19,6 +19,7 @@
 #include <boost/type_traits/is_member_pointer.hpp>
 #include <boost/dll/detail/system_error.hpp>
 #include <boost/dll/detail/aggressive_ptr_cast.hpp>
+#include <boost/dll/detail/unload_hooks.hpp>
 
 #if BOOST_OS_WINDOWS
 #   include <boost/dll/detail/windows/shared_library_impl.hpp>
@@ -26,6 +27,10 @@
 #   include <boost/dll/detail/posix/shared_library_impl.hpp>
 #endif
 
+#ifdef BOOST_DLL_ENABLE_TRACING
+#   include <boost/dll/detail/lifecycle_trace.hpp>
+#endif
+
 #ifdef BOOST_HAS_PRAGMA_ONCE
 # pragma once
 #endif
@@ -176,7 +181,9 @@ public:
     *
     * \throw Nothing.
     */
-    ~shared_library() BOOST_NOEXCEPT {}
+    ~shared_library() BOOST_NOEXCEPT {
+        unload();
+    }
 
     /*!
     * Makes *this share the same shared object as lib. If *this is loaded, then unloads it.
@@ -244,7 +251,7 @@ public:
     void load(const boost::dll::fs::path& lib_path, load_mode::type mode = load_mode::default_mode) {
         boost::dll::fs::error_code ec;
 
-        base_t::load(lib_path, mode, ec);
+        load_impl(lib_path, mode, ec);
 
         if (ec) {
             boost::dll::detail::report_error(ec, "boost::dll::shared_library::load() failed");
@@ -265,13 +272,13 @@ public:
     */
     void load(const boost::dll::fs::path& lib_path, boost::dll::fs::error_code& ec, load_mode::type mode = load_mode::default_mode) {
         ec.clear();
-        base_t::load(lib_path, mode, ec);
+        load_impl(lib_path, mode, ec);
     }
 
     //! \overload void load(const boost::dll::fs::path& lib_path, boost::dll::fs::error_code& ec, load_mode::type mode = load_mode::default_mode)
     void load(const boost::dll::fs::path& lib_path, load_mode::type mode, boost::dll::fs::error_code& ec) {
         ec.clear();
-        base_t::load(lib_path, mode, ec);
+        load_impl(lib_path, mode, ec);
     }
 
     /*!
@@ -279,12 +286,61 @@ public:
     * by different instances, the actual DLL/DSO won't be unloaded until
     * there is at least one instance that references the DLL/DSO.
     *
+    * If this is the last instance that references the DLL/DSO, hooks added by add_unload_hook() are run
+    * before the library is released.
+    *
     * \post this->is_loaded() returns false.
     * \throw Nothing.
     */
     void unload() BOOST_NOEXCEPT {
+        if (is_loaded()) {
+            boost::dll::detail::unload_hooks_on_unload(native());
+        }
+
+#ifdef BOOST_DLL_ENABLE_TRACING
+        const boost::dll::detail::unload_trace trace(native());
+        base_t::unload();
+        trace.finish();
+#else
         base_t::unload();
+#endif
+    }
+
+#if defined(BOOST_DLL_DETAIL_HAS_UNLOAD_HOOKS) || defined(BOOST_DLL_DOXYGEN)
+    /*!
+    * Adds a function that is called right before the DLL/DSO is released by the last shared_library instance
+    * that references it: by unload(), by the destructor or by load() of that instance. Copies and moved-to
+    * instances share the hooks, as they share the library.
+    *
+    * Hooks are called in reverse order of their addition, in the thread that releases the library, without
+    * holding any locks of Boost.DLL or of the OS loader. So a hook could do a long operation, like flushing
+    * a cache, without stalling the loads of libraries in other threads.
+    *
+    * Could be called concurrently from different threads. Exceptions thrown by hooks are ignored.
+    * Requires C++11.
+    *
+    * \b Example:
+    * \code
+    * boost::dll::shared_library lib("libmy_plugin.so");
+    * lib.add_unload_hook(&flush_plugin_cache);
+    * lib.unload(); // calls flush_plugin_cache() and then unloads the library
+    * \endcode
+    *
+    * \param hook Copy constructible function object with signature `void()`.
+    * \throw \forcedlinkfs{system_error} if the library is not loaded, std::bad_alloc in case of insufficient memory.
+    */
+    template <class F>
+    void add_unload_hook(F hook) {
+        if (!is_loaded()) {
+            boost::dll::detail::report_error(
+                boost::dll::fs::make_error_code(boost::dll::fs::errc::bad_file_descriptor),
+                "boost::dll::shared_library::add_unload_hook() failed: no library was loaded"
+            );
+        }
+
+        boost::dll::detail::unload_hooks_registry::instance().add(native(), hook);
     }
+#endif
 
     /*!
     * Check if an library is loaded.
@@ -323,7 +379,7 @@ public:
     */
     bool has(const char* symbol_name) const BOOST_NOEXCEPT {
         boost::dll::fs::error_code ec;
-        return is_loaded() && !!base_t::symbol_addr(symbol_name, ec) && !ec;
+        return is_loaded() && !!symbol_addr(symbol_name, ec) && !ec;
     }
 
     //! \overload bool has(const char* symbol_name) const
@@ -417,13 +473,47 @@ private:
             );
         }
 
-        void* const ret = base_t::symbol_addr(sb, ec);
+        void* const ret = symbol_addr(sb, ec);
         if (ec || !ret) {
             boost::dll::detail::report_error(ec, "boost::dll::shared_library::get() failed");
         }
 
         return ret;
     }
+
+    void load_impl(const boost::dll::fs::path& lib_path, load_mode::type mode, boost::dll::fs::error_code& ec) {
+        // base_t::load() unloads the previous library silently, unload it here to run the hooks and to report it.
+        unload();
+
+#ifdef BOOST_DLL_ENABLE_TRACING
+        const boost::dll::detail::load_trace trace(lib_path, mode);
+        base_t::load(lib_path, mode, ec);
+        trace.finish(native(), ec);
+#else
+        base_t::load(lib_path, mode, ec);
+#endif
+
+        if (is_loaded()) {
+            try {
+                boost::dll::detail::unload_hooks_on_load(native());
+            } catch (...) {
+                // An instance that is not counted must not hold the library, or the hooks could run too early
+                base_t::unload();
+                throw;
+            }
+        }
+    }
+
+    void* symbol_addr(const char* sb, boost::dll::fs::error_code& ec) const BOOST_NOEXCEPT {
+#ifdef BOOST_DLL_ENABLE_TRACING
+        const boost::dll::detail::symbol_trace trace(native(), sb);
+        void* const ret = base_t::symbol_addr(sb, ec);
+        trace.finish(ret && !ec);
+        return ret;
+#else
+        return base_t::symbol_addr(sb, ec);
+#endif
+    }
     /// @endcond
 
 public:
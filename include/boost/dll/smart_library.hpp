@@ -84,6 +84,9 @@ public:
     using mangled_storage = detail::mangled_storage_impl;
     /*!
     * Access to the mangled storage, which is created on construction.
+    * With the Itanium ABI the symbols are demangled on demand, only those that could match the looked up name.
+    * Symbols are shared with the copies of the smart_library and with the other smart_library objects
+    * for the same binary file with the same build-id.
     *
     * \throw Nothing.
     */
@@ -92,6 +95,12 @@ public:
     ///Overload, for current development.
     mangled_storage &symbol_storage() {return _storage;}
 
+    /*!
+    * Decides which symbols are kept in the symbol_storage(), takes the mangled name and is called before the name is demangled.
+    * See mangled_storage::scope_filter() for a filter that keeps the symbols of the specified namespaces and classes.
+    */
+    typedef mangled_storage::symbol_filter symbol_filter;
+
     //! \copydoc shared_library::shared_library()
     smart_library() BOOST_NOEXCEPT {};
 
@@ -101,6 +110,26 @@ public:
         _storage.load(lib_path);
     }
 
+    /*!
+    * Loads a library and keeps only the symbols accepted by filter in the symbol_storage(), so the memory usage
+    * and the construction time depend on the number of accepted symbols. Symbols that are not accepted can not be imported.
+    *
+    * \code
+    * smart_library lib(path, smart_library::mangled_storage::scope_filter({"some_space", "other_space::some_class"}));
+    * \endcode
+    *
+    * \param lib_path Library file name. Can handle std::string, const char*, std::wstring,
+    *           const wchar_t* or boost::dll::fs::path.
+    * \param filter Symbol filter, an empty filter accepts all the symbols.
+    * \param mode A mode that will be used on library load.
+    *
+    * \throw \forcedlinkfs{system_error}, std::bad_alloc in case of insufficient memory.
+    */
+    smart_library(const boost::dll::fs::path& lib_path, const symbol_filter& filter, load_mode::type mode = load_mode::default_mode) {
+        _lib.load(lib_path, mode);
+        _storage.load(lib_path, true, filter);
+    }
+
     //! \copydoc shared_library::shared_library(const boost::dll::fs::path& lib_path, boost::dll::fs::error_code& ec, load_mode::type mode = load_mode::default_mode)
     smart_library(const boost::dll::fs::path& lib_path, boost::dll::fs::error_code& ec, load_mode::type mode = load_mode::default_mode) {
         load(lib_path, mode, ec);
@@ -111,7 +140,7 @@ public:
         load(lib_path, mode, ec);
     }
     /*!
-     * copy a smart_library object.
+     * copy a smart_library object. Symbols and aliases are shared with lib until modified, so copying is cheap.
      *
      * \param lib A smart_library to move from.
      *
@@ -177,6 +206,17 @@ public:
         }
     }
 
+    //! \copydoc smart_library::smart_library(const boost::dll::fs::path& lib_path, const symbol_filter& filter, load_mode::type mode = load_mode::default_mode)
+    void load(const boost::dll::fs::path& lib_path, const symbol_filter& filter, load_mode::type mode = load_mode::default_mode) {
+        boost::dll::fs::error_code ec;
+        _storage.load(lib_path, true, filter);
+        _lib.load(lib_path, mode, ec);
+
+        if (ec) {
+            boost::dll::detail::report_error(ec, "load() failed");
+        }
+    }
+
     //! \copydoc shared_library::load(const boost::dll::fs::path& lib_path, boost::dll::fs::error_code& ec, load_mode::type mode = load_mode::default_mode)
     void load(const boost::dll::fs::path& lib_path, boost::dll::fs::error_code& ec, load_mode::type mode = load_mode::default_mode) {
         ec.clear();
@@ -0,0 +1,309 @@
+// Copyright 2020 Antony Polukhin.
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt
+// or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BOOST_DLL_STATIC_REGISTRY_HPP
+#define BOOST_DLL_STATIC_REGISTRY_HPP
+
+/// \file boost/dll/static_registry.hpp
+/// \brief Contains the BOOST_DLL_STATIC_REGISTER macro and the boost::dll::static_registry class
+/// for enumerating functions and variables of statically linked plugins without dlsym.
+
+#include <boost/dll/config.hpp>
+#include <boost/dll/detail/aggressive_ptr_cast.hpp>
+#include <boost/predef/compiler.h>
+#include <boost/predef/os.h>
+#include <boost/throw_exception.hpp>
+
+#include <cstddef>  // std::ptrdiff_t
+#include <cstring>
+#include <iterator> // std::forward_iterator_tag
+#include <string>
+
+#if BOOST_COMP_GNUC // MSVC does not have <stdint.h> and defines it in some other header, MinGW requires that header.
+#include <stdint.h> // intptr_t
+#endif
+
+#ifdef BOOST_HAS_PRAGMA_ONCE
+# pragma once
+#endif
+
+namespace boost { namespace dll {
+
+/*!
+* \brief Descriptor of a function or variable registered by \forcedmacrolink{BOOST_DLL_STATIC_REGISTER}.
+*/
+struct static_symbol {
+    /// Name of the registered function or variable.
+    const char* name;
+
+    /// Address of the registered function or variable.
+    const void* address;
+};
+
+/// @cond
+#if defined(_MSC_VER)
+
+// Sections with the same name before `$` are merged and sorted by the suffix.
+#pragma section("boostreg$a", read)
+#pragma section("boostreg$m", read)
+#pragma section("boostreg$z", read)
+
+#define BOOST_DLL_DETAIL_STATIC_REGISTRY_ENTRY __declspec(allocate("boostreg$m"))
+
+namespace detail {
+    __declspec(allocate("boostreg$a")) __declspec(selectany) extern const boost::dll::static_symbol static_registry_begin = { 0, 0 };
+    __declspec(allocate("boostreg$z")) __declspec(selectany) extern const boost::dll::static_symbol static_registry_end = { 0, 0 };
+
+    inline const boost::dll::static_symbol* static_registry_first() BOOST_NOEXCEPT {
+        return &static_registry_begin + 1;
+    }
+
+    inline const boost::dll::static_symbol* static_registry_last() BOOST_NOEXCEPT {
+        return &static_registry_end;
+    }
+} // namespace detail
+
+#elif BOOST_OS_MACOS || BOOST_OS_IOS
+
+#define BOOST_DLL_DETAIL_STATIC_REGISTRY_ENTRY __attribute__((used, section("__DATA,boostreg")))
+
+namespace detail {
+    extern const boost::dll::static_symbol static_registry_begin __asm("section$start$__DATA$boostreg");
+    extern const boost::dll::static_symbol static_registry_end __asm("section$end$__DATA$boostreg");
+
+    inline const boost::dll::static_symbol* static_registry_first() BOOST_NOEXCEPT {
+        return &static_registry_begin;
+    }
+
+    inline const boost::dll::static_symbol* static_registry_last() BOOST_NOEXCEPT {
+        return &static_registry_end;
+    }
+} // namespace detail
+
+#elif BOOST_COMP_GNUC || BOOST_COMP_CLANG
+
+#define BOOST_DLL_DETAIL_STATIC_REGISTRY_ENTRY __attribute__((used, section("boostreg")))
+
+// Linker defines those symbols for sections with C identifier names. Weak, because there
+// could be no registered symbols at all.
+extern "C" __attribute__((weak, visibility("hidden"))) const boost::dll::static_symbol __start_boostreg[];
+extern "C" __attribute__((weak, visibility("hidden"))) const boost::dll::static_symbol __stop_boostreg[];
+
+namespace detail {
+    inline const boost::dll::static_symbol* static_registry_first() BOOST_NOEXCEPT {
+        return __start_boostreg;
+    }
+
+    inline const boost::dll::static_symbol* static_registry_last() BOOST_NOEXCEPT {
+        return __stop_boostreg;
+    }
+} // namespace detail
+
+#else
+#  error boost/dll/static_registry.hpp is not supported by this compiler
+#endif
+/// @endcond
+
+
+/*!
+* \brief Registers a function or a variable in the registry of the binary, so that it could be found
+* by boost::dll::static_registry without exporting it and without dlsym.
+*
+* Puts a boost::dll::static_symbol descriptor into the \b "boostreg" section of the binary. Descriptors from all
+* the translation units are merged by the linker into one array.
+*
+* Must be used in namespace scope in exactly one source file for each Name (not in a header).
+* FunctionOrVar must be fully qualified, so that address of it could be taken.
+*
+* \param FunctionOrVar Function or variable to register.
+* \param Name Name of the registered symbol. Must be a valid C identifier, unique per binary.
+*
+* \b Example:
+* \code
+* namespace my_namespace {
+*     boost::shared_ptr<my_plugin_api> create_plugin();
+* }
+*
+* BOOST_DLL_STATIC_REGISTER(my_namespace::create_plugin, create_plugin)
+* \endcode
+*/
+#define BOOST_DLL_STATIC_REGISTER(FunctionOrVar, Name)                                          \
+    namespace _autoaliases {                                                                    \
+        BOOST_DLL_DETAIL_STATIC_REGISTRY_ENTRY                                                  \
+        const boost::dll::static_symbol boost_dll_static_ ## Name = {                           \
+            #Name,                                                                              \
+            reinterpret_cast<const void*>(reinterpret_cast<intptr_t>(&FunctionOrVar))          \
+        };                                                                                      \
+    } /* namespace _autoaliases */                                                              \
+    /**/
+
+
+/*!
+* \brief Range of all the boost::dll::static_symbol descriptors registered by
+* \forcedmacrolink{BOOST_DLL_STATIC_REGISTER} in the current binary.
+*
+* Bounds of the range are provided by the linker, so construction is a constant time operation
+* that does not touch the dynamic symbol table. Unlike boost::dll::shared_library, does not require
+* `-rdynamic` or exported symbols. Each shared library or executable has its own registry.
+*
+* \b Example:
+* \code
+* boost::dll::static_registry registry;
+* for (boost::dll::static_registry::const_iterator it = registry.begin(); it != registry.end(); ++it) {
+*     std::cout << it->name << '\n';
+* }
+*
+* boost::shared_ptr<my_plugin_api> p = registry.get<boost::shared_ptr<my_plugin_api>()>("create_plugin")();
+* \endcode
+*/
+class static_registry {
+public:
+    /// Forward iterator over the registered descriptors.
+    class const_iterator {
+        const boost::dll::static_symbol* it_;
+        const boost::dll::static_symbol* end_;
+
+        // Some linkers pad the merged sections with zeros
+        void skip_padding() BOOST_NOEXCEPT {
+            while (it_ != end_ && !it_->name) {
+                ++it_;
+            }
+        }
+
+    public:
+        typedef std::forward_iterator_tag           iterator_category;
+        typedef boost::dll::static_symbol           value_type;
+        typedef std::ptrdiff_t                      difference_type;
+        typedef const boost::dll::static_symbol*    pointer;
+        typedef const boost::dll::static_symbol&    reference;
+
+        const_iterator() BOOST_NOEXCEPT
+            : it_(0)
+            , end_(0)
+        {}
+
+        const_iterator(const boost::dll::static_symbol* it, const boost::dll::static_symbol* end) BOOST_NOEXCEPT
+            : it_(it)
+            , end_(end)
+        {
+            skip_padding();
+        }
+
+        reference operator*() const BOOST_NOEXCEPT { return *it_; }
+        pointer operator->() const BOOST_NOEXCEPT { return it_; }
+
+        const_iterator& operator++() BOOST_NOEXCEPT {
+            ++it_;
+            skip_padding();
+            return *this;
+        }
+
+        const_iterator operator++(int) BOOST_NOEXCEPT {
+            const_iterator tmp(*this);
+            ++*this;
+            return tmp;
+        }
+
+        friend bool operator==(const const_iterator& lhs, const const_iterator& rhs) BOOST_NOEXCEPT {
+            return lhs.it_ == rhs.it_;
+        }
+
+        friend bool operator!=(const const_iterator& lhs, const const_iterator& rhs) BOOST_NOEXCEPT {
+            return lhs.it_ != rhs.it_;
+        }
+    };
+
+    typedef const_iterator iterator;
+
+private:
+    const boost::dll::static_symbol* first_;
+    const boost::dll::static_symbol* last_;
+
+public:
+    /*!
+    * Takes the bounds of the registry of the binary that contains this constructor call.
+    *
+    * \throw Nothing.
+    */
+    static_registry() BOOST_NOEXCEPT
+        : first_(boost::dll::detail::static_registry_first())
+        , last_(boost::dll::detail::static_registry_last())
+    {
+        if (!first_ || !last_) {
+            first_ = last_ = 0;
+        }
+    }
+
+    /// \return Iterator to the first registered descriptor.
+    const_iterator begin() const BOOST_NOEXCEPT {
+        return const_iterator(first_, last_);
+    }
+
+    /// \return Iterator past the last registered descriptor.
+    const_iterator end() const BOOST_NOEXCEPT {
+        return const_iterator(last_, last_);
+    }
+
+    /// \return true if nothing was registered.
+    bool empty() const BOOST_NOEXCEPT {
+        return begin() == end();
+    }
+
+    /*!
+    * Linear search of the descriptor by name.
+    *
+    * \param name Null-terminated name of the symbol. Can handle std::string, char*, const char*.
+    * \return Pointer to the descriptor or nullptr if there is no symbol with such name.
+    * \throw Nothing.
+    */
+    const boost::dll::static_symbol* find(const char* name) const BOOST_NOEXCEPT {
+        for (const_iterator it = begin(); it != end(); ++it) {
+            if (!std::strcmp(it->name, name)) {
+                return &*it;
+            }
+        }
+
+        return 0;
+    }
+
+    //! \overload const boost::dll::static_symbol* find(const char* name) const
+    const boost::dll::static_symbol* find(const std::string& name) const BOOST_NOEXCEPT {
+        return find(name.c_str());
+    }
+
+    /*!
+    * Returns reference to the registered function or variable. Same semantics as boost::dll::shared_library::get_alias.
+    *
+    * \tparam T Type of the registered symbol.
+    * \param name Null-terminated name of the symbol. Can handle std::string, char*, const char*.
+    * \return Reference to the symbol.
+    * \throw \forcedlinkfs{system_error} if there is no symbol with such name.
+    */
+    template <class T>
+    T& get(const char* name) const {
+        const boost::dll::static_symbol* const s = find(name);
+        if (!s) {
+            boost::throw_exception(
+                boost::dll::fs::system_error(
+                    boost::dll::fs::make_error_code(boost::dll::fs::errc::invalid_argument),
+                    "boost::dll::static_registry::get() failed: symbol is not registered"
+                )
+            );
+        }
+
+        return *boost::dll::detail::aggressive_ptr_cast<T*>(const_cast<void*>(s->address));
+    }
+
+    //! \overload T& get(const char* name) const
+    template <class T>
+    T& get(const std::string& name) const {
+        return get<T>(name.c_str());
+    }
+};
+
+}} // boost::dll
+
+#endif // BOOST_DLL_STATIC_REGISTRY_HPP
@@ -0,0 +1,308 @@
+// Copyright 2020 Antony Polukhin.
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt
+// or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BOOST_DLL_SYMBOLIZER_HPP
+#define BOOST_DLL_SYMBOLIZER_HPP
+
+/// \file boost/dll/symbolizer.hpp
+/// \brief Contains the boost::dll::symbolizer class that maps addresses to modules and symbols.
+
+#include <boost/dll/config.hpp>
+#include <boost/dll/detail/elf_info.hpp>
+#include <boost/dll/runtime_symbol_info.hpp>
+#include <boost/core/demangle.hpp>
+#include <boost/noncopyable.hpp>
+#include <boost/predef/os.h>
+
+#if !BOOST_OS_LINUX && !BOOST_OS_BSD_FREE
+#  error boost/dll/symbolizer.hpp is supported only on platforms with ELF binaries and dl_iterate_phdr
+#endif
+
+#include <algorithm>    // std::sort, std::upper_bound
+#include <exception>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <link.h>   // dl_iterate_phdr
+
+#ifdef BOOST_HAS_PRAGMA_ONCE
+# pragma once
+#endif
+
+namespace boost { namespace dll {
+
+/*!
+* \brief Maps addresses to the modules that contain them and to the nearest symbols of those modules.
+*
+* Unlike boost::dll::symbol_location_ptr() and dladdr() the symbolizer knows about non exported
+* symbols: symbol tables of the modules are read from the `.symtab` section (or from `.dynsym` if
+* the binary is stripped) on the first lookup of an address from that module and are kept as sorted
+* arrays. After that each lookup is two binary searches, suitable for symbolizing big batches of
+* sampled stack frames.
+*
+* List of loaded modules is taken on construction and on refresh() calls.
+*
+* Not thread safe: concurrent calls of non-const member functions must be synchronized by the user.
+*
+* \b Example:
+* \code
+* boost::dll::symbolizer s(true);
+* std::vector<boost::dll::symbolizer::frame> frames = s.symbolize(sampled_addresses);
+* for (std::size_t i = 0; i < frames.size(); ++i) {
+*     std::cout << (frames[i].module ? frames[i].module : "??") << ' '
+*               << (frames[i].symbol ? frames[i].symbol : "??") << '+' << frames[i].offset << '\n';
+* }
+* \endcode
+*/
+class symbolizer: private boost::noncopyable {
+public:
+    /// Result of the lookup. Pointers remain valid until the symbolizer is destroyed or refresh() is called.
+    struct frame {
+        /// Address that was looked up.
+        const void*     address;
+
+        /// Path to the module that contains the address, nullptr if the address does not belong to any loaded module.
+        const char*     module;
+
+        /// Name of the symbol that contains the address, nullptr if there is no such symbol.
+        const char*     symbol;
+
+        /// Offset of the address from the start of the symbol. If there is no symbol - offset
+        /// from the module load bias, suitable for tools like addr2line.
+        std::size_t     offset;
+    };
+
+private:
+    /// @cond
+    struct symbol_entry {
+        std::size_t     begin;
+        std::size_t     size;
+        boost::uint32_t name;
+        bool            global;
+
+        bool operator<(const symbol_entry& rhs) const BOOST_NOEXCEPT {
+            // Global symbols first to prefer them over local aliases
+            return begin < rhs.begin || (begin == rhs.begin && global > rhs.global);
+        }
+    };
+
+    struct module_entry {
+        std::string                 path;
+        std::size_t                 bias;
+        bool                        symbols_loaded;
+        std::vector<symbol_entry>   symbols;
+        std::vector<char>           names;
+        std::vector<std::string>    demangled;  // Lazily filled, index is the same as in `symbols`
+    };
+
+    struct range_entry {
+        std::size_t begin;
+        std::size_t end;
+        std::size_t module;
+
+        bool operator<(const range_entry& rhs) const BOOST_NOEXCEPT {
+            return begin < rhs.begin;
+        }
+    };
+
+    const bool                  demangle_;
+    std::vector<module_entry>   modules_;
+    std::vector<range_entry>    ranges_;
+
+    static int collect_modules(struct dl_phdr_info* info, std::size_t /*size*/, void* data) {
+        symbolizer& self = *static_cast<symbolizer*>(data);
+
+        const std::size_t module = self.modules_.size();
+        self.modules_.push_back(module_entry());
+        module_entry& m = self.modules_.back();
+        m.path = info->dlpi_name ? info->dlpi_name : "";
+        m.bias = static_cast<std::size_t>(info->dlpi_addr);
+        m.symbols_loaded = false;
+
+        for (std::size_t i = 0; i < info->dlpi_phnum; ++i) {
+            if (info->dlpi_phdr[i].p_type != PT_LOAD) {
+                continue;
+            }
+
+            const std::size_t begin = m.bias + static_cast<std::size_t>(info->dlpi_phdr[i].p_vaddr);
+            const range_entry r = { begin, begin + static_cast<std::size_t>(info->dlpi_phdr[i].p_memsz), module };
+            self.ranges_.push_back(r);
+        }
+
+        return 0;
+    }
+
+    static void load_symbols(module_entry& m) {
+        m.symbols_loaded = true;
+
+        std::vector<boost::dll::detail::elf_symbol_address> symbols;
+        try {
+            std::ifstream f(m.path.c_str(), std::ios_base::in | std::ios_base::binary);
+            if (!f) {
+                return; // e.g. vDSO that has no file
+            }
+            f.exceptions(std::ios_base::failbit | std::ifstream::badbit | std::ifstream::eofbit);
+
+            if (sizeof(void*) == 8 && boost::dll::detail::elf_info64::parsing_supported(f)) {
+                boost::dll::detail::elf_info64::symbols_addresses(f, symbols, m.names);
+            } else if (sizeof(void*) == 4 && boost::dll::detail::elf_info32::parsing_supported(f)) {
+                boost::dll::detail::elf_info32::symbols_addresses(f, symbols, m.names);
+            }
+        } catch (const std::exception&) {
+            // Broken or unreadable file, addresses from this module are reported without symbols.
+            m.names.clear();
+            return;
+        }
+
+        m.symbols.reserve(symbols.size());
+        for (std::size_t i = 0; i < symbols.size(); ++i) {
+            const symbol_entry e = {
+                m.bias + static_cast<std::size_t>(symbols[i].value),
+                static_cast<std::size_t>(symbols[i].size),
+                symbols[i].name,
+                symbols[i].global
+            };
+            m.symbols.push_back(e);
+        }
+        std::sort(m.symbols.begin(), m.symbols.end());
+    }
+
+    const char* symbol_name(module_entry& m, std::size_t index) {
+        const char* const mangled = &m.names[m.symbols[index].name];
+        if (!demangle_) {
+            return mangled;
+        }
+
+        if (m.demangled.empty()) {
+            m.demangled.resize(m.symbols.size());
+        }
+
+        std::string& d = m.demangled[index];
+        if (d.empty()) {
+            d = boost::core::demangle(mangled);
+        }
+
+        return d.c_str();
+    }
+
+    void lookup(const void* address, frame& out) {
+        out.address = address;
+        out.module = 0;
+        out.symbol = 0;
+        out.offset = 0;
+
+        const std::size_t addr = reinterpret_cast<std::size_t>(address);
+        const range_entry key = { addr, 0, 0 };
+        std::vector<range_entry>::const_iterator r = std::upper_bound(ranges_.begin(), ranges_.end(), key);
+        if (r == ranges_.begin() || addr >= (--r)->end) {
+            return;
+        }
+
+        module_entry& m = modules_[r->module];
+        out.module = m.path.c_str();
+        out.offset = addr - m.bias;
+        if (!m.symbols_loaded) {
+            load_symbols(m);
+        }
+
+        const symbol_entry sym_key = { addr, 0, 0, false };
+        std::vector<symbol_entry>::const_iterator s = std::upper_bound(m.symbols.begin(), m.symbols.end(), sym_key);
+        if (s == m.symbols.begin()) {
+            return;
+        }
+
+        // Taking the first alias of the nearest address, it is global if there are global aliases
+        --s;
+        std::size_t size = s->size;
+        while (s != m.symbols.begin() && (s - 1)->begin == s->begin) {
+            --s;
+            size = (std::max)(size, s->size);
+        }
+
+        // Symbols without size (like assembly labels) cover everything up to the next symbol
+        if (size && addr >= s->begin + size) {
+            return;
+        }
+
+        out.symbol = symbol_name(m, static_cast<std::size_t>(s - m.symbols.begin()));
+        out.offset = addr - s->begin;
+    }
+
+    void build() {
+        modules_.clear();
+        ranges_.clear();
+        dl_iterate_phdr(&symbolizer::collect_modules, this);
+        std::sort(ranges_.begin(), ranges_.end());
+
+        boost::dll::fs::error_code ignore;
+        const std::string program = boost::dll::program_location(ignore).string();
+        for (std::size_t i = 0; i < modules_.size(); ++i) {
+            if (modules_[i].path.empty()) {
+                modules_[i].path = program;
+            }
+        }
+    }
+    /// @endcond
+
+public:
+    /*!
+    * Takes the list of the currently loaded modules.
+    *
+    * \param demangle If true, C++ symbol names are demangled. Demangled names are cached.
+    * \throw std::bad_alloc in case of insufficient memory.
+    */
+    explicit symbolizer(bool demangle = false)
+        : demangle_(demangle)
+    {
+        build();
+    }
+
+    /*!
+    * Takes the list of the currently loaded modules again and drops all the loaded symbol tables.
+    * Invalidates all the pointers from the previously returned frames.
+    *
+    * \throw std::bad_alloc in case of insufficient memory.
+    */
+    void refresh() {
+        build();
+    }
+
+    /*!
+    * Symbolizes `count` addresses from `addresses` and writes the results into `out`.
+    *
+    * \param addresses Pointer to the addresses.
+    * \param count Count of the addresses.
+    * \param out Pointer to the output array of at least `count` elements.
+    * \throw std::bad_alloc in case of insufficient memory.
+    */
+    void symbolize(const void* const* addresses, std::size_t count, frame* out) {
+        for (std::size_t i = 0; i < count; ++i) {
+            lookup(addresses[i], out[i]);
+        }
+    }
+
+    //! \overload void symbolize(const void* const* addresses, std::size_t count, frame* out)
+    std::vector<frame> symbolize(const std::vector<const void*>& addresses) {
+        std::vector<frame> ret(addresses.size());
+        if (!addresses.empty()) {
+            symbolize(&addresses[0], addresses.size(), &ret[0]);
+        }
+
+        return ret;
+    }
+
+    //! \overload void symbolize(const void* const* addresses, std::size_t count, frame* out)
+    frame symbolize(const void* address) {
+        frame ret;
+        lookup(address, ret);
+        return ret;
+    }
+};
+
+}} // boost::dll
+
+#endif // BOOST_DLL_SYMBOLIZER_HPP
@@ -0,0 +1,144 @@
+// Copyright 2020 Antony Polukhin.
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt
+// or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// For more information, see http://www.boost.org
+
+#include <boost/config.hpp>
+
+#ifndef BOOST_NO_CXX11_CONSTEXPR
+
+#include "../example/b2_workarounds.hpp"
+#include <boost/dll/abi_table.hpp>
+#include <boost/core/lightweight_test.hpp>
+
+#include <vector>
+
+// Must match the one from test_library.cpp
+struct test_table_api {
+    BOOST_STATIC_CONSTANT(unsigned, abi_version = 2);
+
+    int (*increment)(int);
+    float (*version)();
+    std::size_t (*size)(const std::vector<int>&);
+};
+BOOST_DLL_TABLE_LAYOUT(test_table_api, (increment)(version)(size))
+
+struct test_table_api_old {
+    BOOST_STATIC_CONSTANT(unsigned, abi_version = 1);
+
+    int (*increment)(int);
+    float (*version)();
+    std::size_t (*size)(const std::vector<int>&);
+};
+BOOST_DLL_TABLE_LAYOUT(test_table_api_old, (increment)(version)(size))
+
+namespace other {
+    struct test_table_api {
+        BOOST_STATIC_CONSTANT(unsigned, abi_version = 2);
+
+        int (*increment)(int);
+        float (*version)();
+    };
+    BOOST_DLL_TABLE_LAYOUT(test_table_api, (increment)(version))
+
+    // Same size as ::test_table_api, but different signatures
+    struct test_table_api_signatures {
+        BOOST_STATIC_CONSTANT(unsigned, abi_version = 2);
+
+        int (*increment)(long);
+        float (*version)();
+        std::size_t (*size)(std::vector<int>&);
+    };
+    BOOST_DLL_TABLE_LAYOUT(test_table_api_signatures, (increment)(version)(size))
+
+    // Same layout as ::test_table_api, but different names
+    struct renamed_api {
+        BOOST_STATIC_CONSTANT(unsigned, abi_version = 2);
+
+        int (*inc)(int);
+        float (*ver)();
+        std::size_t (*sz)(const std::vector<int>&);
+    };
+    BOOST_DLL_TABLE_LAYOUT(renamed_api, (inc)(ver)(sz))
+}
+
+// Layout hashes are computed at compile time
+static_assert(boost::dll::detail::abi_table_hash<test_table_api>() == boost::dll::detail::abi_table_hash<other::renamed_api>(),
+    "Names of the interface and of its members are not a part of the layout");
+static_assert(boost::dll::detail::abi_table_hash<test_table_api>() != boost::dll::detail::abi_table_hash<other::test_table_api_signatures>(),
+    "Signatures of the members are a part of the layout");
+
+template <class Iface>
+static boost::dll::fs::error_code import_error(const boost::dll::fs::path& path, const char* name) {
+    try {
+        boost::dll::import_table<Iface>(path, name);
+    } catch (const boost::dll::fs::system_error& e) {
+        return e.code();
+    }
+
+    return boost::dll::fs::error_code();
+}
+
+// Unit Tests
+
+int main(int argc, char* argv[])
+{
+    using namespace boost::dll;
+
+    BOOST_TEST(argc >= 2);
+    const boost::dll::fs::path shared_library_path = b2_workarounds::first_lib_from_argv(argc, argv);
+
+    {
+        boost::shared_ptr<const test_table_api> t = import_table<test_table_api>(shared_library_path, "test_table_api");
+        BOOST_TEST_EQ(t->increment(1), 2);
+        BOOST_TEST_EQ(t->version(), 1.0f);
+        std::vector<int> v(5);
+        BOOST_TEST_EQ(t->size(v), 5u);
+
+        shared_library lib(shared_library_path);
+        BOOST_TEST(t->increment == &lib.get<int(int)>("increment"));
+
+        boost::shared_ptr<const test_table_api> named = import_table<test_table_api>(lib, std::string("test_table_api_v2"));
+        BOOST_TEST(named.get() == t.get());
+    }
+
+    {
+        boost::shared_ptr<shared_library> lib = boost::make_shared<shared_library>(shared_library_path);
+        boost::shared_ptr<const test_table_api> t = import_table<test_table_api>(lib, "test_table_api");
+        BOOST_TEST_EQ(lib.use_count(), 2);
+        lib.reset();
+        BOOST_TEST_EQ(t->increment(2), 3);
+    }
+
+    {
+        shared_library lib(shared_library_path);
+        boost::shared_ptr<const test_table_api> t = import_table<test_table_api>(boost::move(lib), "test_table_api");
+        BOOST_TEST(!lib.is_loaded());
+        BOOST_TEST_EQ(t->increment(3), 4);
+    }
+
+    BOOST_TEST(import_error<test_table_api_old>(shared_library_path, "test_table_api")
+        == boost::dll::fs::make_error_code(boost::dll::fs::errc::protocol_not_supported));
+    BOOST_TEST(import_error<other::test_table_api>(shared_library_path, "test_table_api")
+        == boost::dll::fs::make_error_code(boost::dll::fs::errc::invalid_argument));
+    BOOST_TEST(import_error<other::test_table_api_signatures>(shared_library_path, "test_table_api")
+        == boost::dll::fs::make_error_code(boost::dll::fs::errc::invalid_argument));
+    BOOST_TEST(import_error<test_table_api>(shared_library_path, "i_do_not_exist"));
+
+    bool thrown = false;
+    try {
+        import_table<test_table_api>(boost::shared_ptr<shared_library>(), "test_table_api");
+    } catch (const boost::dll::fs::system_error&) {
+        thrown = true;
+    }
+    BOOST_TEST(thrown);
+
+    return boost::report_errors();
+}
+
+#else
+int main() {return 0;}
+#endif
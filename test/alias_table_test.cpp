@@ -0,0 +1,97 @@
+// Copyright 2020 Antony Polukhin.
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt
+// or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// For more information, see http://www.boost.org
+
+#include "../example/b2_workarounds.hpp"
+#include <boost/dll/alias_table.hpp>
+#include <boost/core/lightweight_test.hpp>
+
+#include <vector>
+
+#ifndef BOOST_NO_CXX11_CONSTEXPR
+BOOST_STATIC_ASSERT(boost::dll::detail::alias_table_hash("") == 14695981039346656037ull);
+BOOST_STATIC_ASSERT(boost::dll::detail::alias_table_hash("a") == 0xaf63dc4c8601ec8cull);
+#endif
+
+// Unit Tests
+
+int main(int argc, char* argv[])
+{
+    using namespace boost::dll;
+
+    BOOST_TEST(argc >= 2);
+    const boost::dll::fs::path shared_library_path = b2_workarounds::first_lib_from_argv(argc, argv);
+
+    {
+        shared_library lib(shared_library_path);
+        alias_table t(lib, "test_alias_table");
+        BOOST_TEST_EQ(t.size(), 5u);
+        BOOST_TEST_EQ(std::string(t.name(0)), "increment");
+
+        BOOST_TEST(t.has("increment"));
+        BOOST_TEST(t.has(std::string("const_integer")));
+        BOOST_TEST(!t.has("incremen"));
+        BOOST_TEST(!t.has(""));
+
+        BOOST_TEST_EQ(t.get<int(int)>("increment")(1), 2);
+        BOOST_TEST_EQ(t.get<float()>(std::string("version"))(), 1.0f);
+        std::vector<int> v(3);
+        BOOST_TEST_EQ(t.get<std::size_t(const std::vector<int>&)>("bar")(v), 3u);
+
+        BOOST_TEST(&t.get<int(int)>("increment") == &lib.get<int(int)>("increment"));
+        BOOST_TEST(&t.get<int>("integer") == &lib.get<int>("integer_g"));
+        BOOST_TEST_EQ(t.get<const int>("const_integer"), 777);
+
+        bool thrown = false;
+        try {
+            t.get<int>("i_do_not_exist");
+        } catch (const boost::dll::fs::system_error& e) {
+            thrown = true;
+            BOOST_TEST(e.code() == boost::dll::fs::make_error_code(boost::dll::fs::errc::invalid_argument));
+        }
+        BOOST_TEST(thrown);
+    }
+
+    {
+        shared_library lib(shared_library_path);
+        alias_table t(boost::move(lib), std::string("test_alias_table"));
+        BOOST_TEST(!lib.is_loaded());
+        BOOST_TEST(t.library().is_loaded());
+
+        alias_table copy(t);
+        alias_table moved(boost::move(t));
+        BOOST_TEST_EQ(t.size(), 0u);
+        BOOST_TEST(!t.has("increment"));
+        BOOST_TEST_EQ(moved.get<int(int)>("increment")(2), 3);
+        BOOST_TEST_EQ(copy.get<int(int)>("increment")(3), 4);
+
+        alias_table empty;
+        BOOST_TEST_EQ(empty.size(), 0u);
+        swap(empty, copy);
+        BOOST_TEST_EQ(empty.size(), 5u);
+        BOOST_TEST(!copy.has("increment"));
+    }
+
+    bool thrown = false;
+    try {
+        alias_table t(shared_library(shared_library_path), "not_an_alias_table");
+    } catch (const boost::dll::fs::system_error& e) {
+        thrown = true;
+        BOOST_TEST(e.code() == boost::dll::fs::make_error_code(boost::dll::fs::errc::invalid_argument));
+    }
+    BOOST_TEST(thrown);
+
+    thrown = false;
+    try {
+        alias_table t(shared_library(shared_library_path), "i_do_not_exist");
+    } catch (const boost::dll::fs::system_error&) {
+        thrown = true;
+    }
+    BOOST_TEST(thrown);
+
+    return boost::report_errors();
+}
@@ -228,6 +228,30 @@ int main(int argc, char* argv[])
     }
 
     std::cerr << 28 << ' ';
+    {
+        // Only the symbols accepted by the filter are stored
+        smart_library filtered(pt, smart_library::mangled_storage::scope_filter({"some_space::some_class"}));
+        filtered.add_type_alias<override_class>("some_space::some_class");
+
+        const auto& all = sm.symbol_storage().get_storage();
+        const auto& kept = filtered.symbol_storage().get_storage();
+        BOOST_TEST(!kept.empty());
+        BOOST_TEST_LT(kept.size(), all.size());
+        for (auto& e : kept) {
+            BOOST_TEST(e.demangled.find("some_space::some_class") != std::string::npos);
+        }
+
+        BOOST_TEST((filtered.get_mem_fn<override_class, int(int, int)>("func") == sm.get_mem_fn<override_class, int(int, int)>("func")));
+        BOOST_TEST(filtered.symbol_storage().get_variable<double>("some_space::variable").empty());
+        BOOST_TEST(filtered.symbol_storage().get_function<void(int)>("overloaded").empty());
+
+        smart_library by_predicate;
+        by_predicate.load(pt, [](const std::string& mangled) { return mangled == "unscoped_var"; });
+        BOOST_TEST_EQ(by_predicate.symbol_storage().get_storage().size(), 1u);
+        BOOST_TEST(&by_predicate.get_variable<int>("unscoped_var") == &unscoped_var);
+    }
+
+    std::cerr << 29 << ' ';
     return boost::report_errors();
 }
 
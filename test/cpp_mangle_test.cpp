@@ -17,7 +17,9 @@
 #include <boost/filesystem.hpp>
 #include <boost/variant.hpp>
 
+#include <algorithm>
 #include <iostream>
+#include <thread>
 
 
 struct override_class {};
@@ -35,6 +37,16 @@ int main(int argc, char* argv[])
 
     mangled_storage ms(lib);
 
+    {
+        // get_symbols() reads the symbols without copying the names
+        const auto symbols = ms.get_symbols();
+        BOOST_TEST(!symbols.empty());
+        BOOST_TEST(symbols.begin() + symbols.size() == symbols.end());
+        const mangled_storage& const_ms = ms;
+        BOOST_TEST_EQ(symbols.size(), const_ms.get_storage().size());
+        BOOST_TEST_EQ(symbols[0].demangled, const_ms.get_storage()[0].demangled);
+    }
+
     std::cout << "Symbols: " << std::endl;
 
     for (auto &s : ms.get_storage())
@@ -125,6 +137,202 @@ int main(int argc, char* argv[])
 
 #endif // #ifndef BOOST_NO_RTTI
 
+    {
+        // Entries modified via get_storage() are found
+        mangled_storage copy = ms;
+        copy.get_storage().emplace_back("_Z_some_fake_symbol", "some_space::fake_variable");
+        BOOST_TEST_EQ(copy.get_variable<int>("some_space::fake_variable"), "_Z_some_fake_symbol");
+        BOOST_TEST_EQ(copy.get_variable<double>("some_space::variable"), ms.get_variable<double>("some_space::variable"));
+        BOOST_TEST_EQ(ms.get_variable<int>("some_space::fake_variable"), "");
+    }
+
+    {
+        // Lookups in a storage that was not demangled yet find the same symbols
+        const auto symbols = lib.symbols();
+        for (auto &s : ms.get_storage())
+        {
+            mangled_storage copy(symbols);
+            const auto found = copy.get_variable<int>(s.demangled);
+            BOOST_TEST(!found.empty());
+
+            const auto& entries = copy.get_storage();
+            BOOST_TEST(std::find_if(entries.begin(), entries.end(), [&](const mangled_storage::entry& e) {
+                return e.mangled == found && e.demangled == s.demangled;
+            }) != entries.end());
+        }
+    }
+
+    {
+        // Parallel demangling keeps the order of symbols
+        std::vector<std::string> symbols;
+        for (int i = 0; i < 64; ++i)
+        {
+            const auto lib_symbols = lib.symbols();
+            symbols.insert(symbols.end(), lib_symbols.begin(), lib_symbols.end());
+        }
+
+        mangled_storage serial;
+        serial.add_symbols(symbols);
+        mangled_storage parallel;
+        parallel.add_symbols(symbols, 4);
+
+        const auto& serial_entries = serial.get_storage();
+        const auto& parallel_entries = parallel.get_storage();
+        BOOST_TEST_EQ(serial_entries.size(), symbols.size());
+        BOOST_TEST_EQ(parallel_entries.size(), symbols.size());
+        for (std::size_t i = 0; i < symbols.size() && i < parallel_entries.size(); ++i)
+        {
+            BOOST_TEST_EQ(parallel_entries[i].mangled, symbols[i]);
+            BOOST_TEST_EQ(parallel_entries[i].demangled, serial_entries[i].demangled);
+        }
+
+        BOOST_TEST_EQ(
+            parallel.get_variable<double>("some_space::variable"),
+            ms.get_variable<double>("some_space::variable")
+        );
+    }
+
+    {
+        // Copies share the symbols until modified
+        mangled_storage copy = ms;
+        const mangled_storage& const_copy = copy;
+        const mangled_storage& const_ms = ms;
+        BOOST_TEST(&const_copy.get_storage() == &const_ms.get_storage());
+
+        copy.add_alias<int>("some_alias");
+        BOOST_TEST_EQ(copy.get_name<int>(), "some_alias");
+        BOOST_TEST_NE(ms.get_name<int>(), "some_alias");
+        BOOST_TEST_EQ(copy.get_name<override_class>(), "some_space::some_class");
+
+        const auto size = ms.get_storage().size();
+        copy.add_symbols({"some_extra_symbol"});
+        BOOST_TEST_EQ(ms.get_storage().size(), size);
+        BOOST_TEST_EQ(copy.get_variable<int>("some_extra_symbol"), "some_extra_symbol");
+        BOOST_TEST_EQ(ms.get_variable<int>("some_extra_symbol"), "");
+    }
+
+    if (!library_info(pt).build_id().empty())
+    {
+        // Storages of the libraries with the same build-id share the symbols
+        const mangled_storage first(pt);
+        const mangled_storage second(pt);
+        BOOST_TEST(&first.get_storage() == &second.get_storage());
+        BOOST_TEST_EQ(first.get_variable<double>("some_space::variable"), ms.get_variable<double>("some_space::variable"));
+
+        // Other files with the same build-id, e.g. stripped copies, do not share the symbols
+        const boost::filesystem::path copy_path = boost::filesystem::temp_directory_path()
+            / boost::filesystem::unique_path("cpp_mangle_test_%%%%-%%%%%%");
+        boost::filesystem::copy_file(pt, copy_path);
+        {
+            const mangled_storage copy(copy_path);
+            BOOST_TEST(&first.get_storage() != &copy.get_storage());
+            BOOST_TEST_EQ(copy.get_variable<double>("some_space::variable"), ms.get_variable<double>("some_space::variable"));
+        }
+        boost::filesystem::remove(copy_path);
+    }
+
+    {
+        // Lookups are memoized until the symbols or the aliases change
+        mangled_storage copy = ms;
+        const auto fn = copy.get_mem_fn<override_class, double(double, double)>("func");
+        const auto cv_fn = copy.get_mem_fn<const volatile override_class, double(double, double)>("func");
+        BOOST_TEST(!fn.empty());
+        BOOST_TEST(!cv_fn.empty());
+        BOOST_TEST_NE(fn, cv_fn);
+        BOOST_TEST_EQ((copy.get_mem_fn<override_class, double(double, double)>("func")), fn);
+        BOOST_TEST_EQ((copy.get_mem_fn<const volatile override_class, double(double, double)>("func")), cv_fn);
+
+        struct other_class {};
+        BOOST_TEST(copy.get_constructor<other_class()>().empty());
+        copy.add_alias<other_class>("some_space::some_class");
+        BOOST_TEST(!copy.get_constructor<other_class()>().empty());
+        BOOST_TEST(ms.get_constructor<other_class()>().empty());
+
+        std::vector<std::thread> threads;
+        std::vector<std::string> found(4);
+        for (std::size_t i = 0; i < found.size(); ++i)
+        {
+            threads.emplace_back([&copy, &found, i]() {
+                for (int j = 0; j < 100; ++j)
+                    found[i] = copy.get_function<void(const double)>("overloaded");
+            });
+        }
+        for (auto & t : threads)
+            t.join();
+        for (auto & f : found)
+            BOOST_TEST_EQ(f, ms.get_function<void(const double)>("overloaded"));
+    }
+
+    {
+        // Related symbols are found with the index as with the search over all the names
+        struct some_father {};
+        struct no_such_class {};
+        mangled_storage copy = ms;
+        copy.add_alias<some_father>("some_space::some_father");
+        copy.add_alias<no_such_class>("some_space::no_such_class");
+        copy.add_alias<int>("i");
+
+        const auto related = [&copy](const std::string & name) {
+            std::vector<std::string> ret;
+            for (auto & e : static_cast<const mangled_storage &>(copy).get_storage())
+                if (e.demangled.find(name) != std::string::npos)
+                    ret.push_back(e.demangled);
+            return ret;
+        };
+
+        BOOST_TEST(copy.get_related<override_class>() == related("some_space::some_class"));
+        BOOST_TEST(!copy.get_related<override_class>().empty());
+        BOOST_TEST(copy.get_related<some_father>() == related("some_space::some_father"));
+        BOOST_TEST(!copy.get_related<some_father>().empty());
+        BOOST_TEST(copy.get_related<no_such_class>().empty());
+        BOOST_TEST(copy.get_related<int>() == related("i"));
+    }
+
+#if !defined(_MSC_VER)
+    {
+        // Names produced by the mangler are the names of the symbols
+        detail::itanium_mangler mangler(ms);
+        BOOST_TEST_EQ(mangler.function<void(const double)>("overloaded"), "_Z10overloadedd");
+        BOOST_TEST_EQ(mangler.function<void(const volatile int)>("overloaded"), "_Z10overloadedi");
+        BOOST_TEST_EQ(mangler.function<const int &()>("some_space::scoped_fun"), "_ZN10some_space10scoped_funEv");
+        BOOST_TEST_EQ(
+            mangler.function<void(const int &)>("some_space::some_class::set_value"),
+            "_ZN10some_space10some_class9set_valueERKi"
+        );
+        BOOST_TEST_EQ(
+            (mangler.mem_fn<const volatile override_class, double(double, double)>("func")),
+            "_ZNVK10some_space10some_class4funcEdd"
+        );
+        BOOST_TEST_EQ(mangler.constructor<override_class(override_class &&)>("C1"), "_ZN10some_space10some_classC1EOS0_");
+        BOOST_TEST_EQ(mangler.destructor<override_class>("D1"), "_ZN10some_space10some_classD1Ev");
+        BOOST_TEST_EQ(
+            (mangler.function<void(override_class *, const override_class *, override_class &, const override_class &)>("f")),
+            "_Z1fPN10some_space10some_classEPKS0_RS0_RS2_"
+        );
+
+        BOOST_TEST_EQ(ms.get_function<void(const double)>("overloaded"), "_Z10overloadedd");
+        BOOST_TEST_EQ(ms.get_constructor<override_class(override_class &&)>().C1, "_ZN10some_space10some_classC1EOS0_");
+        BOOST_TEST_EQ(ms.get_destructor<override_class>().D1, "_ZN10some_space10some_classD1Ev");
+
+        // Symbols that the mangler does not find are looked up in the symbols of the class
+        struct int_alias {};
+        mangled_storage aliased = ms;
+        aliased.add_alias<int_alias>("int");
+        BOOST_TEST_EQ(aliased.get_constructor<override_class(int_alias)>().C1, ms.get_constructor<override_class(int)>().C1);
+        BOOST_TEST_EQ(
+            (aliased.get_mem_fn<override_class, int_alias(int_alias, int_alias)>("func")),
+            (ms.get_mem_fn<override_class, int(int, int)>("func"))
+        );
+        BOOST_TEST_EQ(ms.get_vtable<override_class>(), "_ZTVN10some_space10some_classE");
+        BOOST_TEST_EQ(ms.get_type_info<override_class>(), "_ZTIN10some_space10some_classE");
+
+        // Not supported types, the lookup falls back to the demangled names
+        BOOST_TEST_EQ(mangler.function<void(boost::variant<int, double> &)>("use_variant"), "");
+        BOOST_TEST_EQ(mangler.function<void(std::string)>("f"), "");
+        BOOST_TEST_EQ((mangler.mem_fn<override_class, override_class &(override_class &&)>("operator=")), "");
+    }
+#endif
+
     return boost::report_errors();
 }
 
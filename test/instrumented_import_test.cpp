@@ -0,0 +1,138 @@
+// Copyright 2020 Antony Polukhin.
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt
+// or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// For more information, see http://www.boost.org
+
+#include <boost/config.hpp>
+
+#if !defined(BOOST_NO_CXX11_HDR_CHRONO) && !defined(BOOST_NO_CXX11_HDR_ATOMIC) && !defined(BOOST_NO_CXX11_THREAD_LOCAL) \
+    && !defined(BOOST_NO_CXX11_VARIADIC_TEMPLATES) && !defined(BOOST_NO_CXX11_DECLTYPE)
+
+#include "../example/b2_workarounds.hpp"
+#include <boost/dll/instrumented_import.hpp>
+#include <boost/core/lightweight_test.hpp>
+
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+
+static int throw_on_negative(int i) {
+    if (i < 0) {
+        throw std::runtime_error("negative");
+    }
+    return i;
+}
+
+// Unit Tests
+
+int main(int argc, char* argv[])
+{
+    using namespace boost::dll;
+
+    BOOST_TEST(argc >= 2);
+    const boost::dll::fs::path shared_library_path = b2_workarounds::first_lib_from_argv(argc, argv);
+
+    for (std::size_t i = 0; i + 1 < detail::latency_buckets; ++i) {
+        const boost::uint64_t upper = detail::latency_bucket_upper_bound(i);
+        BOOST_TEST_EQ(detail::latency_bucket(upper), i);
+        BOOST_TEST_EQ(detail::latency_bucket(upper + 1), i + 1);
+    }
+    BOOST_TEST_EQ(detail::latency_bucket(~static_cast<boost::uint64_t>(0)), detail::latency_buckets - 1);
+
+    {
+        instrumented_function<int(int)> f = instrumented_import<int(int)>(shared_library_path, "increment");
+        BOOST_TEST_EQ(f(1), 2);
+
+        std::thread t([f]() {
+            for (int i = 0; i < 1000; ++i) {
+                f(i);
+            }
+        });
+        for (int i = 0; i < 1000; ++i) {
+            f(i);
+        }
+        t.join();
+
+        const call_metrics_snapshot s = f.snapshot();
+#ifndef BOOST_DLL_DISABLE_INSTRUMENTATION
+        BOOST_TEST_EQ(s.name, "increment");
+        BOOST_TEST_EQ(s.calls, 2001u);
+        BOOST_TEST_EQ(s.errors, 0u);
+
+        boost::uint64_t sum = 0;
+        for (std::size_t i = 0; i < s.buckets.size(); ++i) {
+            sum += s.buckets[i];
+        }
+        BOOST_TEST_EQ(sum, s.calls);
+        BOOST_TEST(s.percentile(0.5) <= s.percentile(0.99));
+        BOOST_TEST(s.percentile(1.0) >= s.percentile(0.0));
+#else
+        BOOST_TEST(s.name.empty());
+        BOOST_TEST_EQ(s.calls, 0u);
+        BOOST_TEST_EQ(sizeof(f), sizeof(boost::shared_ptr<int(int)>));
+#endif
+        BOOST_TEST_EQ(call_metrics_snapshot().percentile(0.5).count(), 0);
+    }
+
+    {
+        boost::shared_ptr<shared_library> lib = boost::make_shared<shared_library>(shared_library_path);
+        instrumented_function<float()> f = instrumented_import<float()>(lib, std::string("lib_version"));
+        BOOST_TEST_EQ(lib.use_count(), 2);
+        lib.reset();
+        BOOST_TEST_EQ(f(), 1.0f);
+    }
+
+    {
+        instrumented_function<int(int)> f(boost::shared_ptr<shared_library>(), &throw_on_negative, "throw_on_negative");
+        BOOST_TEST_EQ(f(1), 1);
+
+        bool thrown = false;
+        try {
+            f(-1);
+        } catch (const std::runtime_error&) {
+            thrown = true;
+        }
+        BOOST_TEST(thrown);
+
+#ifndef BOOST_DLL_DISABLE_INSTRUMENTATION
+        BOOST_TEST_EQ(f.snapshot().calls, 2u);
+        BOOST_TEST_EQ(f.snapshot().errors, 1u);
+#endif
+
+        std::ostringstream ss;
+        call_metrics_snapshot snapshot = f.snapshot();
+        snapshot.name = "throw_on_negative";
+        write_prometheus(ss, snapshot);
+        const std::string text = ss.str();
+        BOOST_TEST(text.find("boost_dll_calls_total{function=\"throw_on_negative\"}") != std::string::npos);
+        BOOST_TEST(text.find("boost_dll_call_duration_seconds_bucket{function=\"throw_on_negative\",le=\"+Inf\"}") != std::string::npos);
+
+        // Bucket bounds do not depend on the recorded calls
+        std::size_t buckets = 0;
+        for (std::size_t pos = text.find("_bucket{"); pos != std::string::npos; pos = text.find("_bucket{", pos + 1)) {
+            ++buckets;
+        }
+        BOOST_TEST_EQ(buckets, detail::prometheus_max_exponent - detail::prometheus_min_exponent + 2);
+        BOOST_TEST(text.find("le=\"1.023e-06\"") != std::string::npos);
+
+        f.metrics().reset();
+        BOOST_TEST_EQ(f.snapshot().calls, 0u);
+    }
+
+    bool thrown = false;
+    try {
+        instrumented_import<int(int)>(boost::shared_ptr<shared_library>(), "increment");
+    } catch (const boost::dll::fs::system_error&) {
+        thrown = true;
+    }
+    BOOST_TEST(thrown);
+
+    return boost::report_errors();
+}
+
+#else // C++11
+int main() {}
+#endif
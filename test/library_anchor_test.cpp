@@ -0,0 +1,76 @@
+// Copyright 2020 Antony Polukhin.
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt
+// or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// For more information, see http://www.boost.org
+
+#include "../example/b2_workarounds.hpp"
+#include <boost/dll/library_anchor.hpp>
+#include <boost/core/lightweight_test.hpp>
+#include <boost/shared_ptr.hpp>
+
+#include <vector>
+
+struct anchor_holding_deleter {
+    boost::dll::library_anchor_ptr anchor;
+
+    void operator()(int* p) const {
+        delete p;
+    }
+};
+
+// Unit Tests
+
+int main(int argc, char* argv[])
+{
+    using namespace boost::dll;
+
+    BOOST_TEST(argc >= 2);
+    const boost::dll::fs::path shared_library_path = b2_workarounds::first_lib_from_argv(argc, argv);
+
+    {
+        library_anchor_ptr anchor = make_library_anchor(shared_library_path);
+        BOOST_TEST(anchor->library().is_loaded());
+        BOOST_TEST_EQ(anchor->use_count(), 1u);
+
+        std::vector<boost::shared_ptr<int> > objects;
+        for (int i = 0; i < 100; ++i) {
+            anchor_holding_deleter deleter = { anchor };
+            objects.push_back(boost::shared_ptr<int>(new int(i), deleter));
+        }
+        BOOST_TEST_EQ(anchor->use_count(), 101u);
+
+        int (&increment)(int) = anchor->library().get<int(int)>("increment");
+        library_anchor* const raw = anchor.get();
+        anchor.reset();
+        BOOST_TEST_EQ(raw->use_count(), 100u);
+        BOOST_TEST(raw->library().is_loaded());
+        BOOST_TEST_EQ(increment(1), 2);
+
+        objects.resize(1);
+        BOOST_TEST_EQ(raw->use_count(), 1u);
+    }
+
+    {
+        shared_library lib(shared_library_path);
+        library_anchor_ptr copied = make_library_anchor(lib);
+        BOOST_TEST(copied->library().is_loaded());
+        BOOST_TEST(lib.is_loaded());
+
+        library_anchor_ptr moved = make_library_anchor(boost::move(lib));
+        BOOST_TEST(!lib.is_loaded());
+        BOOST_TEST(moved->library().native() == copied->library().native());
+    }
+
+    bool thrown = false;
+    try {
+        make_library_anchor("i_do_not_exist.so");
+    } catch (const boost::dll::fs::system_error&) {
+        thrown = true;
+    }
+    BOOST_TEST(thrown);
+
+    return boost::report_errors();
+}
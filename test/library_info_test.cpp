@@ -12,13 +12,26 @@
 #include "../example/b2_workarounds.hpp"
 
 #include <boost/dll/library_info.hpp>
+#include <boost/dll/section_view.hpp>
+#include <boost/dll/shared_library.hpp>
 #include <boost/core/lightweight_test.hpp>
 #include "../example/tutorial4/static_plugin.hpp"
 
 // Unit Tests
 
+#include <algorithm>
 #include <iterator>
 
+static std::vector<std::string> names_of(const std::vector<boost::dll::section_entry>& entries) {
+    std::vector<std::string> ret;
+    for (std::size_t i = 0; i < entries.size(); ++i) {
+        ret.push_back(entries[i].name);
+    }
+
+    std::sort(ret.begin(), ret.end());
+    return ret;
+}
+
 int main(int argc, char* argv[])
 {
     boost::dll::fs::path shared_library_path = b2_workarounds::first_lib_from_argv(argc, argv);
@@ -49,6 +62,39 @@ int main(int argc, char* argv[])
 
     BOOST_TEST(lib_info.symbols("section_that_does_not_exist").empty());
 
+    {
+        boost::dll::shared_library lib(shared_library_path);
+        const std::vector<boost::dll::section_entry> entries = boost::dll::section_view(lib, "boostdll");
+        std::vector<std::string> expected = lib_info.symbols("boostdll");
+        std::sort(expected.begin(), expected.end());
+        BOOST_TEST(names_of(entries) == expected);
+        for (std::size_t i = 0; i < entries.size(); ++i) {
+            BOOST_TEST(entries[i].address == lib.get<void*>(entries[i].name));
+        }
+
+        BOOST_TEST(boost::dll::section_view(lib, std::string("section_that_does_not_exist")).empty());
+    }
+
+    boost::optional<boost::dll::plugin_manifest> manifest = lib_info.manifest();
+    BOOST_TEST(!!manifest);
+    if (manifest) {
+        BOOST_TEST_EQ(manifest->name, "test_library");
+        BOOST_TEST_EQ(manifest->version_major, 1u);
+        BOOST_TEST_EQ(manifest->version_minor, 2u);
+        BOOST_TEST_EQ(manifest->version_patch, 3u);
+        BOOST_TEST_EQ(manifest->abi_version, 4u);
+    }
+#if !BOOST_OS_WINDOWS
+    // Every binary has a record with the same name, so the record is not exported
+    BOOST_TEST(!boost::dll::shared_library(shared_library_path).has("boost_dll_manifest"));
+#endif
+
+    const std::string build_id = lib_info.build_id();
+    std::cout << "Build-id: " << build_id << '\n';
+    BOOST_TEST(build_id.size() % 2 == 0);
+    BOOST_TEST(build_id.find_first_not_of("0123456789abcdef") == std::string::npos);
+    BOOST_TEST_EQ(build_id, lib_info.build_id());
+
     // Self testing
     std::cout << "Self: " << argv[0];
     boost::dll::library_info self_info(argv[0]);
@@ -61,5 +107,7 @@ int main(int argc, char* argv[])
     std::copy(symb.begin(), symb.end(), std::ostream_iterator<std::string>(std::cout, "\n"));
     BOOST_TEST(std::find(symb.begin(), symb.end(), "create_plugin") != symb.end());
 
+    BOOST_TEST(!self_info.manifest());
+
     return boost::report_errors();
 }
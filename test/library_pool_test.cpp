@@ -0,0 +1,152 @@
+// Copyright 2020 Antony Polukhin.
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt
+// or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// For more information, see http://www.boost.org
+
+#include <boost/config.hpp>
+
+#ifndef BOOST_NO_CXX11_HDR_MUTEX
+
+#include "../example/b2_workarounds.hpp"
+#include <boost/dll/library_pool.hpp>
+#include <boost/core/lightweight_test.hpp>
+
+// Unit Tests
+
+inline boost::dll::fs::path do_find_correct_libs_path(int argc, char* argv[], const char* lib_name) {
+    boost::dll::fs::path ret;
+
+    for (int i = 1; i < argc; ++i) {
+        ret = argv[i];
+        if (ret.string().find(lib_name) != std::string::npos && b2_workarounds::is_shared_library(ret)) {
+            return ret;
+        }
+    }
+
+    return lib_name;
+}
+
+int main(int argc, char* argv[])
+{
+    using namespace boost::dll;
+
+    BOOST_TEST(argc >= 3);
+    const boost::dll::fs::path test_library_path = do_find_correct_libs_path(argc, argv, "test_library");
+    const boost::dll::fs::path library1_path = do_find_correct_libs_path(argc, argv, "library1");
+
+    boost::shared_ptr<shared_library> outlives_pool;
+    {
+        library_pool pool(1);
+        BOOST_TEST_EQ(pool.max_idle_count(), 1u);
+        BOOST_TEST_EQ(pool.max_idle_bytes(), 0u);
+
+        boost::shared_ptr<shared_library> lib1 = pool.load(test_library_path);
+        BOOST_TEST(lib1);
+        BOOST_TEST(lib1->has("say_hello"));
+        BOOST_TEST_EQ(pool.statistics().misses, 1u);
+        BOOST_TEST_EQ(pool.statistics().hits, 0u);
+
+        boost::shared_ptr<shared_library> lib2 = pool.load(test_library_path);
+        BOOST_TEST(lib1 == lib2);
+        BOOST_TEST_EQ(pool.statistics().misses, 1u);
+        BOOST_TEST_EQ(pool.statistics().hits, 1u);
+        BOOST_TEST_EQ(pool.statistics().loaded_count, 1u);
+        BOOST_TEST_EQ(pool.statistics().idle_count, 0u);
+
+        // Different mode is a different key
+        boost::shared_ptr<shared_library> lib3 = pool.load(test_library_path, load_mode::rtld_now);
+        BOOST_TEST(lib3 != lib1);
+        BOOST_TEST(*lib3 == *lib1);
+        BOOST_TEST_EQ(pool.statistics().misses, 2u);
+        BOOST_TEST_EQ(pool.statistics().loaded_count, 2u);
+        lib3.reset();
+
+        void* const native = lib1->native();
+        lib1.reset();
+        lib2.reset();
+        BOOST_TEST_EQ(pool.statistics().idle_count, 1u);
+        BOOST_TEST_EQ(pool.statistics().evictions, 1u);
+#if BOOST_OS_LINUX || BOOST_OS_WINDOWS
+        BOOST_TEST(pool.statistics().idle_bytes > 0);
+#endif
+
+        // Idle library is taken from the pool
+        lib1 = pool.load(test_library_path);
+        BOOST_TEST_EQ(lib1->native(), native);
+        BOOST_TEST_EQ(pool.statistics().hits, 2u);
+        BOOST_TEST_EQ(pool.statistics().idle_count, 0u);
+        BOOST_TEST_EQ(pool.statistics().idle_bytes, 0u);
+
+        // Least recently used library is evicted
+        boost::shared_ptr<shared_library> other = pool.load(library1_path);
+        BOOST_TEST(other->is_loaded());
+        lib1.reset();
+        other.reset();
+        BOOST_TEST_EQ(pool.statistics().idle_count, 1u);
+        BOOST_TEST_EQ(pool.statistics().evictions, 2u);
+        BOOST_TEST_EQ(pool.statistics().loaded_count, 1u);
+
+        other = pool.load(library1_path);
+        BOOST_TEST_EQ(pool.statistics().misses, 3u);
+        BOOST_TEST_EQ(pool.statistics().hits, 3u);
+
+        outlives_pool = pool.load(test_library_path);
+        BOOST_TEST_EQ(pool.statistics().misses, 4u);
+
+        other.reset();
+        pool.clear();
+        BOOST_TEST_EQ(pool.statistics().idle_count, 0u);
+        BOOST_TEST_EQ(pool.statistics().loaded_count, 1u);
+
+        // Errors
+        boost::dll::fs::error_code ec;
+        BOOST_TEST(!pool.load("i_do_not_exist", ec));
+        BOOST_TEST(ec);
+
+        bool thrown = false;
+        try {
+            pool.load("i_do_not_exist");
+        } catch (const boost::dll::fs::system_error&) {
+            thrown = true;
+        }
+        BOOST_TEST(thrown);
+        BOOST_TEST_EQ(pool.statistics().loaded_count, 1u);
+    }
+
+    BOOST_TEST(outlives_pool->is_loaded());
+    BOOST_TEST(outlives_pool->has("say_hello"));
+    outlives_pool.reset();
+
+    {
+#if BOOST_OS_LINUX || BOOST_OS_WINDOWS
+        // Any library exceeds the budget of 1 byte
+        library_pool pool(100, 1);
+        pool.load(test_library_path);
+        BOOST_TEST_EQ(pool.statistics().idle_count, 0u);
+        BOOST_TEST_EQ(pool.statistics().evictions, 1u);
+#endif
+
+        library_pool unlimited(100);
+        unlimited.load(test_library_path);
+        unlimited.load(library1_path);
+        BOOST_TEST_EQ(unlimited.statistics().idle_count, 2u);
+
+        unlimited.set_limits(1);
+        BOOST_TEST_EQ(unlimited.max_idle_count(), 1u);
+        BOOST_TEST_EQ(unlimited.statistics().idle_count, 1u);
+
+        unlimited.load(library1_path);
+        BOOST_TEST_EQ(unlimited.statistics().misses, 2u);
+    }
+
+    return boost::report_errors();
+}
+
+#else // #ifndef BOOST_NO_CXX11_HDR_MUTEX
+
+int main() {}
+
+#endif
@@ -0,0 +1,133 @@
+// Copyright 2020 Antony Polukhin.
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt
+// or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// For more information, see http://www.boost.org
+
+#include <boost/config.hpp>
+
+#ifndef BOOST_NO_CXX11_HDR_CHRONO
+
+#include "../example/b2_workarounds.hpp"
+#include <boost/dll/library_stats.hpp>
+#include <boost/dll/runtime_symbol_info.hpp>
+#include <boost/core/lightweight_test.hpp>
+
+// Unit Tests
+
+int main(int argc, char* argv[])
+{
+    using namespace boost::dll;
+
+    BOOST_TEST(argc >= 2);
+    const boost::dll::fs::path shared_library_path = b2_workarounds::first_lib_from_argv(argc, argv);
+
+    {
+        shared_library lib;
+        boost::dll::fs::error_code ec;
+        stats(lib, ec);
+        BOOST_TEST(ec);
+
+        bool thrown = false;
+        try {
+            stats(lib);
+        } catch (const boost::dll::fs::system_error&) {
+            thrown = true;
+        }
+        BOOST_TEST(thrown);
+    }
+
+#ifdef BOOST_DLL_ENABLE_TRACING
+    {
+        // Not tracked while the collection is disabled
+        shared_library lib(shared_library_path);
+        BOOST_TEST(lib.has("say_hello"));
+        BOOST_TEST_EQ(stats(lib).resolved_symbols, 0u);
+        BOOST_TEST_EQ(stats(lib).load_duration.count(), 0);
+    }
+#endif
+    BOOST_TEST(!set_stats_collection(true));
+
+#ifdef BOOST_DLL_ENABLE_TRACING
+    {
+        // Unload while the collection is disabled releases the data of the library
+        {
+            shared_library first(shared_library_path);
+            BOOST_TEST(first.has("say_hello"));
+            BOOST_TEST(set_stats_collection(false));
+        }
+        BOOST_TEST(!set_stats_collection(true));
+
+        shared_library second(shared_library_path);
+        BOOST_TEST_EQ(stats(second).resolved_symbols, 0u);
+    }
+
+    {
+        // Instances loaded while the collection is disabled are counted
+        BOOST_TEST(set_stats_collection(false));
+        shared_library first(shared_library_path);
+        BOOST_TEST(!set_stats_collection(true));
+        {
+            shared_library copy(first);
+        }
+        BOOST_TEST(first.has("say_hello"));
+        BOOST_TEST_EQ(stats(first).resolved_symbols, 1u);
+    }
+#endif
+
+#if BOOST_OS_LINUX || BOOST_OS_WINDOWS || BOOST_OS_BSD_FREE
+    shared_library lib(shared_library_path);
+    BOOST_TEST(lib.has("say_hello"));
+    lib.get<int>("integer_g") = 200; // dirties the data page
+
+    const library_stats s = stats(lib);
+    BOOST_TEST(!s.regions.empty());
+    BOOST_TEST(s.mapped_bytes > 0);
+
+    const void* const symbol = &lib.get<int>("integer_g");
+    bool found = false;
+    std::size_t sum = 0;
+    for (std::size_t i = 0; i < s.regions.size(); ++i) {
+        const char* const begin = static_cast<const char*>(s.regions[i].begin);
+        found = found || (begin <= symbol && symbol < begin + s.regions[i].size);
+        sum += s.regions[i].size;
+    }
+    BOOST_TEST(found);
+    BOOST_TEST_EQ(sum, s.mapped_bytes);
+
+#if BOOST_OS_LINUX || BOOST_OS_BSD_FREE
+    BOOST_TEST(s.resident_bytes > 0);
+    BOOST_TEST(s.dirty_bytes > 0);
+#endif
+
+#ifdef BOOST_DLL_ENABLE_TRACING
+    BOOST_TEST(s.load_duration.count() > 0);
+    BOOST_TEST_EQ(s.resolved_symbols, 2u);
+
+    {
+        shared_library copy(lib);
+        copy.has("say_hello");
+        copy.has("i_do_not_exist");
+    }
+    BOOST_TEST_EQ(stats(lib).resolved_symbols, 4u);
+    BOOST_TEST(stats(lib).load_duration == s.load_duration);
+#else
+    BOOST_TEST_EQ(s.load_duration.count(), 0);
+    BOOST_TEST_EQ(s.resolved_symbols, 0u);
+#endif
+
+    // Self
+    const library_stats self = stats(shared_library(program_location()));
+    BOOST_TEST(!self.regions.empty());
+#endif
+
+    return boost::report_errors();
+}
+
+#else // #ifndef BOOST_NO_CXX11_HDR_CHRONO
+
+int main() {}
+
+#endif
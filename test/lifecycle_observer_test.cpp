@@ -0,0 +1,180 @@
+// Copyright 2020 Antony Polukhin.
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt
+// or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// For more information, see http://www.boost.org
+
+#include <boost/config.hpp>
+
+#if !defined(BOOST_NO_CXX11_HDR_MUTEX) && defined(BOOST_DLL_ENABLE_TRACING)
+
+#include "../example/b2_workarounds.hpp"
+#include <boost/dll/shared_library.hpp>
+#include <boost/dll/smart_library.hpp>
+#include <boost/dll/lifecycle_observer.hpp>
+#include <boost/core/lightweight_test.hpp>
+
+#include <sstream>
+#include <vector>
+
+// Unit Tests
+
+struct counting_observer: boost::dll::lifecycle_observer {
+    unsigned load_begins = 0;
+    unsigned load_ends = 0;
+    unsigned load_failures = 0;
+    unsigned unloads = 0;
+    unsigned symbol_hits = 0;
+    unsigned symbol_misses = 0;
+    unsigned storage_builds = 0;
+    std::size_t storage_symbols = 0;
+    std::vector<boost::dll::fs::path> unloaded;
+    boost::dll::fs::path symbol_lib_path;
+
+    void on_load_begin(const boost::dll::fs::path&, boost::dll::load_mode::type, clock_type::time_point) override {
+        ++load_begins;
+    }
+
+    void on_load_end(const boost::dll::fs::path&, boost::dll::load_mode::type, const boost::dll::fs::error_code& ec,
+        clock_type::time_point, clock_type::duration duration) override
+    {
+        BOOST_TEST(duration.count() >= 0);
+        ++load_ends;
+        if (ec) {
+            ++load_failures;
+        }
+    }
+
+    void on_unload(const boost::dll::fs::path& lib_path, clock_type::time_point, clock_type::duration) override {
+        ++unloads;
+        unloaded.push_back(lib_path);
+    }
+
+    void on_symbol(const boost::dll::fs::path& lib_path, const char* symbol_name, bool found,
+        clock_type::time_point, clock_type::duration) override
+    {
+        BOOST_TEST(!lib_path.empty());
+        BOOST_TEST(symbol_name);
+        symbol_lib_path = lib_path;
+        ++(found ? symbol_hits : symbol_misses);
+    }
+
+    void on_storage_build(const boost::dll::fs::path&, std::size_t symbols_count,
+        clock_type::time_point, clock_type::duration) override
+    {
+        ++storage_builds;
+        storage_symbols = symbols_count;
+    }
+};
+
+struct throwing_observer: boost::dll::lifecycle_observer {
+    void on_symbol(const boost::dll::fs::path&, const char*, bool, clock_type::time_point, clock_type::duration) override {
+        throw std::runtime_error("must be ignored");
+    }
+};
+
+int main(int argc, char* argv[])
+{
+    using namespace boost::dll;
+
+    BOOST_TEST(argc >= 2);
+    const boost::dll::fs::path shared_library_path = b2_workarounds::first_lib_from_argv(argc, argv);
+
+    BOOST_TEST(!get_lifecycle_observer());
+
+    counting_observer observer;
+    BOOST_TEST(!set_lifecycle_observer(&observer));
+    BOOST_TEST(get_lifecycle_observer() == &observer);
+
+    {
+        shared_library lib(shared_library_path);
+        BOOST_TEST_EQ(observer.load_begins, 1u);
+        BOOST_TEST_EQ(observer.load_ends, 1u);
+        BOOST_TEST_EQ(observer.load_failures, 0u);
+
+        BOOST_TEST(lib.has("say_hello"));
+        BOOST_TEST(!lib.has("i_do_not_exist"));
+        lib.get<int>("integer_g");
+        BOOST_TEST_EQ(observer.symbol_hits, 2u);
+        BOOST_TEST_EQ(observer.symbol_misses, 1u);
+
+        // Reloading reports the unload of the previous library
+        lib.load(shared_library_path);
+        BOOST_TEST_EQ(observer.load_ends, 2u);
+        BOOST_TEST_EQ(observer.unloads, 1u);
+
+        boost::dll::fs::error_code ec;
+        lib.load("i_do_not_exist", ec);
+        BOOST_TEST(ec);
+        BOOST_TEST_EQ(observer.load_ends, 3u);
+        BOOST_TEST_EQ(observer.load_failures, 1u);
+        BOOST_TEST_EQ(observer.unloads, 2u);
+    }
+    BOOST_TEST_EQ(observer.unloads, 2u);
+
+    {
+        shared_library lib(shared_library_path);
+    }
+    BOOST_TEST_EQ(observer.unloads, 3u);
+    BOOST_TEST(boost::dll::fs::equivalent(observer.unloaded.back(), shared_library_path));
+
+    {
+        // Path is resolved on load, even if the observer is installed later
+        set_lifecycle_observer(nullptr);
+        shared_library lib(shared_library_path);
+        set_lifecycle_observer(&observer);
+
+        const unsigned hits = observer.symbol_hits;
+        BOOST_TEST(lib.has("say_hello"));
+        BOOST_TEST(lib.has("say_hello"));
+        BOOST_TEST_EQ(observer.symbol_hits, hits + 2);
+        BOOST_TEST(boost::dll::fs::equivalent(observer.symbol_lib_path, shared_library_path));
+    }
+    BOOST_TEST_EQ(observer.unloads, 4u);
+    BOOST_TEST(boost::dll::fs::equivalent(observer.unloaded.back(), shared_library_path));
+
+    {
+        experimental::smart_library sm(shared_library_path);
+        BOOST_TEST_EQ(observer.storage_builds, 1u);
+        BOOST_TEST(observer.storage_symbols > 0);
+        BOOST_TEST_EQ(observer.storage_symbols, sm.symbol_storage().get_storage().size());
+    }
+
+    {
+        throwing_observer thrower;
+        set_lifecycle_observer(&thrower);
+        shared_library lib(shared_library_path);
+        BOOST_TEST(lib.has("say_hello"));
+    }
+
+    std::ostringstream trace;
+    {
+        chrome_trace_observer tracer(trace);
+        set_lifecycle_observer(&tracer);
+        {
+            shared_library lib(shared_library_path);
+            lib.has("say_hello");
+            lib.has("i_do_not_\"exist\"");
+        }
+        set_lifecycle_observer(nullptr);
+    }
+
+    const std::string json = trace.str();
+    BOOST_TEST(json.find("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[") == 0);
+    BOOST_TEST(json.find("\"name\":\"load\"") != std::string::npos);
+    BOOST_TEST(json.find("\"name\":\"unload\"") != std::string::npos);
+    BOOST_TEST(json.find("\"symbol\":\"say_hello\",\"found\":true") != std::string::npos);
+    BOOST_TEST(json.find("\"symbol\":\"i_do_not_\\\"exist\\\"\",\"found\":false") != std::string::npos);
+    BOOST_TEST(json.find("\"ph\":\"X\"") != std::string::npos);
+    BOOST_TEST(json.find("\n]}\n") == json.size() - 4);
+
+    return boost::report_errors();
+}
+
+#else // #if !defined(BOOST_NO_CXX11_HDR_MUTEX) && defined(BOOST_DLL_ENABLE_TRACING)
+
+int main() {}
+
+#endif
@@ -0,0 +1,128 @@
+// Copyright 2020 Antony Polukhin.
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt
+// or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// For more information, see http://www.boost.org
+
+#ifdef BOOST_DLL_DEBUG_PINNED_FUNCTIONS
+#   define BOOST_ENABLE_ASSERT_HANDLER
+#endif
+
+#include "../example/b2_workarounds.hpp"
+#include <boost/dll/pinned_function.hpp>
+#include <boost/core/lightweight_test.hpp>
+
+#include <stdexcept>
+#include <vector>
+
+#ifdef BOOST_DLL_DEBUG_PINNED_FUNCTIONS
+namespace boost {
+    void assertion_failed(char const* /*expr*/, char const* /*function*/, char const* /*file*/, long /*line*/) {
+        throw std::logic_error("assertion");
+    }
+
+    void assertion_failed_msg(char const* /*expr*/, char const* /*msg*/, char const* /*function*/, char const* /*file*/, long /*line*/) {
+        throw std::logic_error("assertion");
+    }
+} // namespace boost
+#endif
+
+// Unit Tests
+
+int main(int argc, char* argv[])
+{
+    using namespace boost::dll;
+
+    BOOST_TEST(argc >= 2);
+    const boost::dll::fs::path shared_library_path = b2_workarounds::first_lib_from_argv(argc, argv);
+
+#ifndef BOOST_DLL_DEBUG_PINNED_FUNCTIONS
+    BOOST_TEST_EQ(sizeof(pinned_function<int(int)>), sizeof(void(*)()));
+#endif
+
+    pinned_function<int(int)> empty;
+    BOOST_TEST(!empty);
+
+    std::vector<pinned_function<int(int)> > table;
+    {
+        library_scope scope(shared_library_path);
+        BOOST_TEST(scope.library().is_loaded());
+
+        pinned_function<int(int)> inc = scope.get<int(int)>("increment");
+        BOOST_TEST(inc);
+        BOOST_TEST(inc.get() == &scope.library().get<int(int)>("increment"));
+        BOOST_TEST_EQ(inc.get()(1), 2);
+        table.resize(1000, inc);
+
+        pinned_function<std::size_t(const std::vector<int>&)> sz
+            = scope.get_alias<std::size_t(const std::vector<int>&)>(std::string("foo_bar"));
+        std::vector<int> v(10);
+        BOOST_TEST_EQ(sz.get()(v), 10u);
+
+#if !defined(BOOST_NO_CXX11_TRAILING_RESULT_TYPES) && !defined(BOOST_NO_CXX11_DECLTYPE) && !defined(BOOST_NO_CXX11_VARIADIC_TEMPLATES) && !defined(BOOST_NO_CXX11_RVALUE_REFERENCES)
+        BOOST_TEST_EQ(table[999](41), 42);
+        BOOST_TEST_EQ(sz(v), 10u);
+#endif
+
+        // Functions survive moves of the scope
+        library_scope moved(boost::move(scope));
+        BOOST_TEST(!scope.library().is_loaded());
+        BOOST_TEST_EQ(table[0].get()(1), 2);
+
+        bool thrown = false;
+        try {
+            moved.get<int(int)>("i_do_not_exist");
+        } catch (const boost::dll::fs::system_error&) {
+            thrown = true;
+        }
+        BOOST_TEST(thrown);
+    }
+
+#ifdef BOOST_DLL_DEBUG_PINNED_FUNCTIONS
+    bool asserted = false;
+    try {
+        table[0].get();
+    } catch (const std::logic_error&) {
+        asserted = true;
+    }
+    BOOST_TEST(asserted);
+#endif
+
+    {
+        // Move assignment releases the previous library of the target
+        shared_library lib(shared_library_path);
+        library_scope target(lib);
+        pinned_function<int(int)> old_inc = target.get<int(int)>("increment");
+
+        library_scope source(shared_library_path);
+        pinned_function<int(int)> inc = source.get<int(int)>("increment");
+
+        target = boost::move(source);
+        BOOST_TEST(!source.library().is_loaded());
+        BOOST_TEST(target.library().is_loaded());
+        BOOST_TEST_EQ(inc.get()(1), 2);
+
+#ifdef BOOST_DLL_DEBUG_PINNED_FUNCTIONS
+        asserted = false;
+        try {
+            old_inc.get();
+        } catch (const std::logic_error&) {
+            asserted = true;
+        }
+        BOOST_TEST(asserted);
+#else
+        (void)old_inc;
+#endif
+    }
+
+    {
+        shared_library lib(shared_library_path);
+        library_scope scope(lib);
+        BOOST_TEST(scope.library() == lib);
+        BOOST_TEST_EQ(scope.get<int(int)>("increment").get()(2), 3);
+    }
+
+    return boost::report_errors();
+}
@@ -113,6 +113,30 @@ void refcountable_test(boost::dll::fs::path shared_library_path) {
         s.swap(s2);
         BOOST_TEST(*s2 == "I am a std::string from the test_library (Think of me as of 'Hello world'. Long 'Hello world').");
     }
+
+    {
+        // Imports share the library without copying it
+        boost::shared_ptr<shared_library> lib = boost::make_shared<shared_library>(shared_library_path);
+        boost::function<say_hello_func> f = import<say_hello_func>(lib, "say_hello");
+        boost::shared_ptr<const int> i = import<const int>(lib, std::string("const_integer_g"));
+        boost::shared_ptr<std::string> s = import_alias<std::string>(lib, "info");
+        boost::function<std::size_t(const std::vector<int>&)> sz = import_alias<std::size_t(const std::vector<int>&)>(lib, std::string("foo_bar"));
+        BOOST_TEST_EQ(lib.use_count(), 5);
+
+        lib.reset();
+        BOOST_TEST(*i == 777);
+        BOOST_TEST(sz(v) == 1000);
+        BOOST_TEST(*s == "I am a std::string from the test_library (Think of me as of 'Hello world'. Long 'Hello world').");
+        f();
+
+        bool thrown = false;
+        try {
+            import<const int>(lib, "const_integer_g");
+        } catch (const boost::dll::fs::system_error&) {
+            thrown = true;
+        }
+        BOOST_TEST(thrown);
+    }
 }
 
 // exe function
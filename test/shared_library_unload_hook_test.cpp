@@ -0,0 +1,230 @@
+// Copyright 2020 Antony Polukhin.
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt
+// or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// For more information, see http://www.boost.org
+
+#include <boost/config.hpp>
+
+#if !defined(BOOST_NO_CXX11_HDR_ATOMIC) && !defined(BOOST_NO_CXX11_HDR_FUNCTIONAL)
+
+#include "../example/b2_workarounds.hpp"
+#include <boost/dll/shared_library.hpp>
+#include <boost/core/lightweight_test.hpp>
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#ifndef BOOST_NO_CXX11_HDR_THREAD
+#   include <atomic>
+#   include <thread>
+#endif
+
+static std::string calls;
+
+struct append {
+    char c;
+    const boost::dll::shared_library* lib;
+
+    void operator()() const {
+        if (lib) {
+            // Library is still loaded when the hook runs
+            BOOST_TEST(lib->is_loaded());
+            BOOST_TEST(lib->has("increment"));
+        }
+        calls += c;
+    }
+};
+
+static append make_append(char c, const boost::dll::shared_library* lib = 0) {
+    const append ret = { c, lib };
+    return ret;
+}
+
+static void throwing_hook() {
+    calls += 't';
+    throw std::runtime_error("ignored");
+}
+
+struct adding_hook {
+    boost::dll::shared_library* lib;
+
+    void operator()() const {
+        calls += 'n';
+        lib->add_unload_hook(make_append('x'));
+    }
+};
+
+// Unit Tests
+
+int main(int argc, char* argv[])
+{
+    using namespace boost::dll;
+
+    BOOST_TEST(argc >= 2);
+    const boost::dll::fs::path shared_library_path = b2_workarounds::first_lib_from_argv(argc, argv);
+
+    {
+        shared_library lib(shared_library_path);
+        lib.add_unload_hook(make_append('a', &lib));
+        lib.add_unload_hook(make_append('b', &lib));
+        lib.add_unload_hook(&throwing_hook);
+        lib.add_unload_hook(make_append('c', &lib));
+        BOOST_TEST_EQ(calls, "");
+
+        lib.unload();
+        BOOST_TEST_EQ(calls, "ctba");
+        BOOST_TEST(!lib.is_loaded());
+
+        lib.unload();
+        BOOST_TEST_EQ(calls, "ctba");
+    }
+
+    calls.clear();
+    {
+        shared_library lib(shared_library_path);
+        lib.add_unload_hook(make_append('d'));
+    }
+    BOOST_TEST_EQ(calls, "d");
+
+    calls.clear();
+    {
+        shared_library lib(shared_library_path);
+        lib.add_unload_hook(make_append('l'));
+        lib.load(shared_library_path);
+        BOOST_TEST_EQ(calls, "l");
+        BOOST_TEST(lib.is_loaded());
+    }
+    BOOST_TEST_EQ(calls, "l");
+
+    calls.clear();
+    {
+        shared_library lib(shared_library_path);
+        lib.add_unload_hook(make_append('m'));
+
+        shared_library copy(lib);
+        copy.unload();
+        BOOST_TEST_EQ(calls, "");
+
+        shared_library moved(boost::move(lib));
+        lib.unload();
+        BOOST_TEST_EQ(calls, "");
+
+        shared_library assigned;
+        assigned = boost::move(moved);
+        moved.unload();
+        BOOST_TEST_EQ(calls, "");
+
+        assigned.unload();
+        BOOST_TEST_EQ(calls, "m");
+    }
+
+    calls.clear();
+    {
+        // Hooks belong to the library, not to the instance that added them
+        shared_library lib(shared_library_path);
+        {
+            shared_library copy(lib);
+            copy.add_unload_hook(make_append('p'));
+        }
+        BOOST_TEST_EQ(calls, "");
+
+        shared_library other(shared_library_path);
+        lib.unload();
+        BOOST_TEST_EQ(calls, "");
+
+        other.unload();
+        BOOST_TEST_EQ(calls, "p");
+
+        lib.load(shared_library_path);
+        lib.unload();
+        BOOST_TEST_EQ(calls, "p");
+    }
+
+    calls.clear();
+    {
+        shared_library lib(shared_library_path);
+        adding_hook hook = { &lib };
+        lib.add_unload_hook(hook);
+        lib.unload();
+        BOOST_TEST_EQ(calls, "nx");
+    }
+
+    {
+        shared_library lib;
+        bool thrown = false;
+        try {
+            lib.add_unload_hook(make_append('e'));
+        } catch (const boost::dll::fs::system_error& e) {
+            thrown = true;
+            BOOST_TEST(e.code() == boost::dll::fs::make_error_code(boost::dll::fs::errc::bad_file_descriptor));
+        }
+        BOOST_TEST(thrown);
+    }
+
+#ifndef BOOST_NO_CXX11_HDR_THREAD
+    {
+        static std::atomic<int> counter(0);
+        struct count {
+            void operator()() const {
+                ++counter;
+            }
+        };
+
+        shared_library lib(shared_library_path);
+        std::vector<std::thread> threads;
+        for (int i = 0; i < 4; ++i) {
+            threads.push_back(std::thread([&lib]() {
+                for (int j = 0; j < 1000; ++j) {
+                    lib.add_unload_hook(count());
+                }
+            }));
+        }
+        for (std::size_t i = 0; i < threads.size(); ++i) {
+            threads[i].join();
+        }
+
+        lib.unload();
+        BOOST_TEST_EQ(counter, 4000);
+    }
+
+    {
+        // Copies made and released concurrently do not run the hooks
+        static std::atomic<int> runs(0);
+        struct count {
+            void operator()() const {
+                ++runs;
+            }
+        };
+
+        shared_library lib(shared_library_path);
+        lib.add_unload_hook(count());
+        std::vector<std::thread> threads;
+        for (int i = 0; i < 4; ++i) {
+            threads.push_back(std::thread([&lib]() {
+                for (int j = 0; j < 100; ++j) {
+                    shared_library copy(lib);
+                }
+            }));
+        }
+        for (std::size_t i = 0; i < threads.size(); ++i) {
+            threads[i].join();
+        }
+
+        BOOST_TEST_EQ(runs, 0);
+        lib.unload();
+        BOOST_TEST_EQ(runs, 1);
+    }
+#endif
+
+    return boost::report_errors();
+}
+
+#else // #if !defined(BOOST_NO_CXX11_HDR_ATOMIC) && !defined(BOOST_NO_CXX11_HDR_FUNCTIONAL)
+
+int main() {}
+
+#endif
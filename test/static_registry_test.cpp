@@ -0,0 +1,62 @@
+// Copyright 2020 Antony Polukhin.
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt
+// or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// For more information, see http://www.boost.org
+
+#include <boost/dll/static_registry.hpp>
+#include <boost/core/lightweight_test.hpp>
+#include "../example/tutorial4/static_plugin.hpp"
+
+#include <cstring>
+
+namespace some_namespace {
+    int twice(int i) {
+        return i * 2;
+    }
+
+    int variable = 42;
+}
+
+BOOST_DLL_STATIC_REGISTER(some_namespace::twice, twice)
+BOOST_DLL_STATIC_REGISTER(some_namespace::variable, variable)
+
+// Unit Tests
+
+int main()
+{
+    using namespace boost::dll;
+
+    static_registry registry;
+    BOOST_TEST(!registry.empty());
+
+    std::size_t count = 0;
+    bool has_plugin = false;
+    for (static_registry::const_iterator it = registry.begin(); it != registry.end(); ++it) {
+        ++count;
+        has_plugin = has_plugin || !std::strcmp(it->name, "create_plugin");
+    }
+    BOOST_TEST_EQ(count, 3u);
+    BOOST_TEST(has_plugin);
+
+    BOOST_TEST_EQ(registry.get<int(int)>("twice")(2), 4);
+    BOOST_TEST(&registry.get<int(int)>(std::string("twice")) == &some_namespace::twice);
+    BOOST_TEST_EQ(registry.get<int>("variable"), 42);
+    BOOST_TEST(&registry.get<int>("variable") == &some_namespace::variable);
+
+    boost::shared_ptr<my_plugin_api> plugin = registry.get<boost::shared_ptr<my_plugin_api>()>("create_plugin")();
+    BOOST_TEST_EQ(plugin->name(), "static");
+
+    BOOST_TEST(!registry.find("i_do_not_exist"));
+    bool thrown = false;
+    try {
+        registry.get<int>("i_do_not_exist");
+    } catch (const boost::dll::fs::system_error&) {
+        thrown = true;
+    }
+    BOOST_TEST(thrown);
+
+    return boost::report_errors();
+}
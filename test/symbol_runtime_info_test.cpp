@@ -69,6 +69,9 @@ int main(int argc, char* argv[]) {
 
     make_error_code_dirty();
 
+    // Cached data about loaded modules must be refreshed after the load
+    BOOST_TEST(boost::dll::fs::equivalent(symbol_location(internal_function), argv[0]));
+
     shared_library lib(shared_library_path);
 
     std::cout << std::endl;
@@ -126,6 +129,8 @@ int main(int argc, char* argv[]) {
         make_error_code_dirty();
 
         shared_library sl(program_location());
+        BOOST_TEST(program_location() == program_location());
+        BOOST_TEST(this_line_location() == program_location());
 
         make_error_code_dirty();
 
@@ -225,6 +230,18 @@ int main(int argc, char* argv[]) {
         BOOST_TEST(ec);
     }
 
+    {
+        // Address outside of all the modules, twice to check the lookup without a rebuild
+        int* heap_value = new int(42);
+        boost::dll::fs::error_code ec;
+        symbol_location_ptr(heap_value, ec);
+        BOOST_TEST(ec);
+
+        ec.clear();
+        symbol_location_ptr(heap_value, ec);
+        BOOST_TEST(ec);
+        delete heap_value;
+    }
 
     return boost::report_errors();
 }
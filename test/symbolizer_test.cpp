@@ -0,0 +1,112 @@
+// Copyright 2020 Antony Polukhin.
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt
+// or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// For more information, see http://www.boost.org
+
+#include <boost/predef/os.h>
+
+#if BOOST_OS_LINUX || BOOST_OS_BSD_FREE
+
+#include "../example/b2_workarounds.hpp"
+#include <boost/dll/symbolizer.hpp>
+#include <boost/dll/shared_library.hpp>
+#include <boost/core/lightweight_test.hpp>
+
+#include <cstring>
+
+// Not exported, dladdr() does not know about those symbols
+static int local_function(int i) {
+    return i * 2;
+}
+
+namespace some_namespace {
+    BOOST_NOINLINE int hidden_function(int i, char c) {
+        return i + c;
+    }
+}
+
+int hidden_variable = 10;
+
+// Unit Tests
+
+int main(int argc, char* argv[])
+{
+    using namespace boost::dll;
+
+    BOOST_TEST(argc >= 2);
+    const boost::dll::fs::path shared_library_path = b2_workarounds::first_lib_from_argv(argc, argv);
+
+    shared_library lib(shared_library_path);
+    const char* const say_hello = reinterpret_cast<const char*>(&lib.get<void()>("say_hello"));
+    BOOST_TEST(local_function(1) == 2);
+    BOOST_TEST(some_namespace::hidden_function(1, 2) == 3);
+
+    {
+        symbolizer s;
+
+        symbolizer::frame f = s.symbolize(say_hello + 1);
+        BOOST_TEST(f.address == say_hello + 1);
+        BOOST_TEST(f.module && f.module == lib.location().string());
+        BOOST_TEST(f.symbol && std::strcmp(f.symbol, "say_hello") == 0);
+        BOOST_TEST_EQ(f.offset, 1u);
+
+        int (*local)(int) = &local_function;
+        f = s.symbolize(reinterpret_cast<const void*>(local));
+        BOOST_TEST(f.module && boost::dll::fs::equivalent(f.module, program_location()));
+        BOOST_TEST(f.symbol && std::strstr(f.symbol, "local_function"));
+        BOOST_TEST_EQ(f.offset, 0u);
+
+        f = s.symbolize(&hidden_variable);
+        BOOST_TEST(f.symbol && std::strcmp(f.symbol, "hidden_variable") == 0);
+
+        // Mangled names by default
+        int (*hidden)(int, char) = &some_namespace::hidden_function;
+        f = s.symbolize(reinterpret_cast<const void*>(hidden));
+        BOOST_TEST(f.symbol && std::strncmp(f.symbol, "_Z", 2) == 0);
+
+        f = s.symbolize(static_cast<const void*>(0));
+        BOOST_TEST(!f.module);
+        BOOST_TEST(!f.symbol);
+
+        // Batch
+        std::vector<const void*> addresses;
+        addresses.push_back(say_hello);
+        addresses.push_back(0);
+        addresses.push_back(reinterpret_cast<const void*>(local));
+        addresses.push_back(say_hello);
+        const std::vector<symbolizer::frame> frames = s.symbolize(addresses);
+        BOOST_TEST_EQ(frames.size(), 4u);
+        BOOST_TEST(frames[0].symbol && frames[0].symbol == frames[3].symbol);
+        BOOST_TEST(!frames[1].module);
+        BOOST_TEST(frames[2].symbol && std::strstr(frames[2].symbol, "local_function"));
+    }
+
+    {
+        symbolizer s(true);
+        int (*hidden)(int, char) = &some_namespace::hidden_function;
+        const symbolizer::frame f = s.symbolize(reinterpret_cast<const void*>(hidden));
+        BOOST_TEST(f.symbol && std::strcmp(f.symbol, "some_namespace::hidden_function(int, char)") == 0);
+
+        // Demangled names are cached
+        BOOST_TEST(f.symbol == s.symbolize(reinterpret_cast<const void*>(hidden)).symbol);
+    }
+
+    {
+        symbolizer s;
+        lib.unload();
+        s.refresh();
+        const symbolizer::frame f = s.symbolize(&hidden_variable);
+        BOOST_TEST(f.symbol && std::strcmp(f.symbol, "hidden_variable") == 0);
+    }
+
+    return boost::report_errors();
+}
+
+#else // #if BOOST_OS_LINUX || BOOST_OS_BSD_FREE
+
+int main() {}
+
+#endif
@@ -75,6 +75,9 @@ BOOST_DLL_ALIAS(namespace1::namespace2::namespace3::info, info)
 BOOST_DLL_ALIAS(const_integer_g, const_integer_g_alias)
 BOOST_DLL_ALIAS(namespace1::namespace2::namespace3::ref_returning_function, ref_returning_function)
 
+#include <boost/dll/manifest.hpp>
+BOOST_DLL_MANIFEST("test_library", 1, 2, 3, 4)
+
 
 
 int integer_g = 100;
@@ -113,3 +116,41 @@ extern "C" LIBRARY_API int&& rvalue_reference_to_internal_integer;
 int&& rvalue_reference_to_internal_integer = static_cast<int&&>(internal_integer_i);
 #endif
 
+
+
+
+#ifndef BOOST_NO_CXX11_CONSTEXPR
+#include <boost/dll/abi_table.hpp>
+
+struct test_table_api {
+    BOOST_STATIC_CONSTANT(unsigned, abi_version = 2);
+
+    int (*increment)(int);
+    float (*version)();
+    std::size_t (*size)(const std::vector<int>&);
+};
+BOOST_DLL_TABLE_LAYOUT(test_table_api, (increment)(version)(size))
+
+namespace table_impl {
+    const test_table_api table = { &increment, &lib_version, &foo::bar };
+}
+
+BOOST_DLL_EXPORT_TABLE(test_table_api, table_impl::table)
+BOOST_DLL_EXPORT_TABLE_NAMED(test_table_api, table_impl::table, test_table_api_v2)
+#endif
+
+
+
+#include <boost/dll/alias_table.hpp>
+
+BOOST_DLL_ALIAS_TABLE_BEGIN(test_alias_table)
+    BOOST_DLL_ALIAS_TABLE_ENTRY(increment, increment)
+    BOOST_DLL_ALIAS_TABLE_ENTRY(lib_version, version)
+    BOOST_DLL_ALIAS_TABLE_ENTRY(foo::bar, bar)
+    BOOST_DLL_ALIAS_TABLE_ENTRY(integer_g, integer)
+    BOOST_DLL_ALIAS_TABLE_ENTRY(const_integer_g, const_integer)
+BOOST_DLL_ALIAS_TABLE_END(test_alias_table)
+
+// Exported data that is big enough to hold an alias table header, but is not a table
+extern "C" LIBRARY_API const unsigned char not_an_alias_table[64];
+const unsigned char not_an_alias_table[64] = {0};